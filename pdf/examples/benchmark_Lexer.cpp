@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "vrock/pdf/parser/BaseParser.hpp"
+#include "vrock/utils.hpp"
+
+using namespace vrock::pdf;
+
+// the lexer primitives as they were before the character class table, kept to compare against
+struct LegacyLexer
+{
+    LegacyLexer( std::string s, long o ) : _string( std::move( s ) ), _offset( o )
+    {
+    }
+
+    auto is_whitespace( char c ) -> bool
+    {
+        return std::find( _whitespace.begin( ), _whitespace.end( ), c ) != _whitespace.end( );
+    }
+
+    auto is_delimiter( char c ) -> bool
+    {
+        return std::find( _delimiter.begin( ), _delimiter.end( ), c ) != _delimiter.end( );
+    }
+
+    auto is_digit_plus_minus_dot( char c ) -> bool
+    {
+        return ( c >= '0' && c <= '9' ) || c == '+' || c == '-' || c == '.';
+    }
+
+    auto skip_comments_and_whitespaces( ) -> void
+    {
+        while ( _offset < _string.length( ) && is_whitespace( _string[ _offset ] ) )
+            _offset++;
+    }
+
+    auto parse_double( ) -> double
+    {
+        std::stringstream ss{ };
+        while ( _offset < _string.length( ) )
+        {
+            if ( !is_digit_plus_minus_dot( _string[ _offset ] ) )
+                break;
+            ss.put( _string[ _offset ] );
+            if ( _string[ _offset++ ] == '.' )
+                break;
+        }
+        while ( _offset < _string.length( ) && _string[ _offset ] >= '0' && _string[ _offset ] <= '9' )
+            ss.put( _string[ _offset++ ] );
+        return strtod( ss.str( ).c_str( ), nullptr );
+    }
+
+    auto is_keyword( std::string key ) -> bool
+    {
+        for ( size_t i = _offset; i < _offset + key.length( ); i++ )
+            if ( i >= _string.length( ) || _string[ i ] != key[ i - _offset ] )
+                return false;
+        _offset += key.length( );
+        return true;
+    }
+
+    std::string _string;
+    size_t _offset = 0;
+
+    std::vector<char> _whitespace = { '\0', '\t', '\n', '\f', '\r', ' ' };
+    std::vector<char> _delimiter = { '<', '>', '(', ')', '[', ']', '{', '}', '/', '%' };
+};
+
+// splits the input into numbers, keywords and delimiters
+template <typename Lexer>
+auto count_tokens( Lexer &lexer ) -> std::size_t
+{
+    std::size_t tokens = 0;
+    double sum = 0;
+    while ( true )
+    {
+        lexer.skip_comments_and_whitespaces( );
+        if ( lexer._offset >= lexer._string.length( ) )
+            break;
+        auto c = lexer._string[ lexer._offset ];
+        if ( lexer.is_digit_plus_minus_dot( c ) )
+            sum += lexer.parse_double( );
+        else if ( lexer.is_keyword( "true" ) || lexer.is_keyword( "null" ) )
+        {
+        }
+        else if ( lexer.is_delimiter( c ) )
+            lexer._offset++;
+        else
+            while ( lexer._offset < lexer._string.length( ) && !lexer.is_whitespace( lexer._string[ lexer._offset ] ) &&
+                    !lexer.is_delimiter( lexer._string[ lexer._offset ] ) )
+                lexer._offset++;
+        tokens++;
+    }
+    // keep the parsed numbers alive
+    if ( sum == -1 )
+        std::cout << sum;
+    return tokens;
+}
+
+template <typename Lexer>
+auto run( const std::string &name, const std::string &input, int iterations ) -> void
+{
+    std::size_t tokens = 0;
+    vrock::utils::Timer timer;
+    for ( int i = 0; i < iterations; i++ )
+    {
+        Lexer lexer( input, 0 );
+        tokens += count_tokens( lexer );
+    }
+    auto us = std::max<std::uint64_t>( 1, timer.elapsed<std::chrono::microseconds>( ) );
+    std::cout << name << ": " << tokens << " tokens in " << us / 1000 << "ms, " << tokens * 1000000 / us
+              << " tokens/s" << std::endl;
+}
+
+int main( int argc, char **argv )
+{
+    auto iterations = argc > 1 ? std::atoi( argv[ 1 ] ) : 20;
+
+    // a typical text and path heavy content stream
+    std::string input;
+    for ( int i = 0; i < 20000; i++ )
+        input += "BT /F1 12 Tf 0.5 0 0 1 72.25 " + std::to_string( i % 800 ) +
+                 " Tm (Hello) Tj ET\n1 0 0 RG 100 200 m 300.5 -400 l S [1 2] 0 d null true\n";
+
+    run<LegacyLexer>( "legacy", input, iterations );
+    run<BaseParser>( "table ", input, iterations );
+
+    return 0;
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "structure/PDFContext.hpp"
 #include "structure/PDFEncryption.hpp"
 #include "structure/PDFPageTree.hpp"
+#include "writer/PDFWriter.hpp"
 
 #include <filesystem>
 
@@ -15,19 +16,41 @@ namespace vrock::pdf
          */
         Overwrite,
         /**
-         * @brief Appends to the end of the PDF file (incremental update)
+         * @brief Appends modified objects to the end of the PDF file (incremental update)
          * */
-        Append // needs implementation
+        Append
+    };
+
+    enum class PDFOpenMode
+    {
+        /**
+         * @brief Reads the whole file into memory
+         */
+        Buffered,
+        /**
+         * @brief Maps the file into memory, the file must not be modified while the document is open
+         * */
+        MemoryMapped
     };
 
     class PDFDocument //:  std::enable_shared_from_this<PDFDocument>
     {
     public:
         PDFDocument( );
-        PDFDocument( std::filesystem::path path );
+        PDFDocument( std::filesystem::path path, PDFOpenMode mode = PDFOpenMode::Buffered );
+        /**
+         * @brief opens the document like the constructor above, large cross-reference tables are decoded on the pool
+         */
+        PDFDocument( std::filesystem::path path, utils::ThreadPool &pool, PDFOpenMode mode = PDFOpenMode::Buffered );
 
-        // TODO: implement
+        /**
+         * @brief writes the document to the file it was opened from
+         */
         auto save( PDFSaveMode mode = PDFSaveMode::Overwrite ) -> void;
+        /**
+         * @brief writes the document to path. the file is replaced once the new document is complete, so path may be
+         * the file the document was opened from. once it was overwritten, the document cannot be appended to it
+         */
         auto save( std::filesystem::path path, PDFSaveMode mode = PDFSaveMode::Overwrite ) -> void;
 
         auto get_path( ) -> std::filesystem::path
@@ -55,13 +78,67 @@ namespace vrock::pdf
             return page_tree.get_page_count( );
         }
 
+        auto get_pages_parallel( utils::ThreadPool &pool ) -> utils::List<std::shared_ptr<Page>>
+        {
+            return page_tree.get_pages_parallel( pool );
+        }
+
+        auto extract_text_parallel( utils::ThreadPool &pool ) -> std::vector<utils::List<std::shared_ptr<Text>>>
+        {
+            return page_tree.extract_text_parallel( pool );
+        }
+
+        /**
+         * @brief decodes and indexes all object streams concurrently, so later object access does not have to
+         */
+        auto prefetch_object_streams( utils::ThreadPool &pool ) -> std::size_t
+        {
+            return context->prefetch_object_streams( pool );
+        }
+
+        auto get_trailer( ) -> std::shared_ptr<PDFDictionary>
+        {
+            return context->trailer;
+        }
+
+        /**
+         * @brief adds a new indirect object, it has to be referenced by another object to be part of the document
+         */
+        auto add_object( std::shared_ptr<PDFBaseObject> obj ) -> std::shared_ptr<PDFRef>
+        {
+            return context->add_object( std::move( obj ) );
+        }
+
+        /**
+         * @brief options used when the document is saved
+         */
+        auto set_write_options( PDFWriteOptions options ) -> void
+        {
+            write_options = options;
+        }
+
+        /**
+         * @brief limits the memory used by resolved objects, evicted objects are parsed again on access
+         */
+        auto set_cache_policy( PDFCachePolicy policy ) -> void
+        {
+            context->cache.set_policy( policy );
+        }
+
         // TODO: abstract away?
         std::shared_ptr<PDFBaseSecurityHandler> decryption_handler;
         std::shared_ptr<PDFBaseSecurityHandler> encryption_handler;
 
     private:
+        PDFDocument( std::filesystem::path path, PDFOpenMode mode, utils::ThreadPool *pool );
+
+        auto append( const std::filesystem::path &path ) -> void;
+
         std::filesystem::path file_path;
+        // set once file_path was replaced by an Overwrite save, incremental updates would not match it anymore
+        bool source_rewritten = false;
         PDFPageTree page_tree;
+        PDFWriteOptions write_options;
         // std::vector<std::shared_ptr<Page>> pages;
 
         std::shared_ptr<PDFContext> context;
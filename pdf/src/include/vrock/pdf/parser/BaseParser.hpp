@@ -1,49 +1,137 @@
 #pragma once
 
+#include "InputSource.hpp"
+
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <exception>
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 namespace vrock::pdf
 {
+    /**
+     * @brief character classes of the lexer, a character can be in multiple classes
+     */
+    enum class CharClass : std::uint8_t
+    {
+        Regular = 0,
+        Whitespace = 1 << 0,
+        Delimiter = 1 << 1,
+        Digit = 1 << 2,
+        Sign = 1 << 3,
+        Dot = 1 << 4,
+        EndOfLine = 1 << 5,
+    };
+
+    constexpr auto operator|( CharClass a, CharClass b ) -> CharClass
+    {
+        return static_cast<CharClass>( std::to_underlying( a ) | std::to_underlying( b ) );
+    }
+
+    inline constexpr auto char_classes = [] {
+        std::array<std::uint8_t, 256> table{ };
+        for ( unsigned char c : std::string_view( "\0\t\n\f\r ", 6 ) )
+            table[ c ] |= std::to_underlying( CharClass::Whitespace );
+        for ( unsigned char c : std::string_view( "<>()[]{}/%" ) )
+            table[ c ] |= std::to_underlying( CharClass::Delimiter );
+        for ( unsigned char c = '0'; c <= '9'; c++ )
+            table[ c ] |= std::to_underlying( CharClass::Digit );
+        table[ '+' ] |= std::to_underlying( CharClass::Sign );
+        table[ '-' ] |= std::to_underlying( CharClass::Sign );
+        table[ '.' ] |= std::to_underlying( CharClass::Dot );
+        table[ '\n' ] |= std::to_underlying( CharClass::EndOfLine );
+        return table;
+    }( );
+
+    class PDFParserException : public std::exception
+    {
+    public:
+        explicit PDFParserException( std::string m ) : message( std::move( m ) )
+        {
+        }
+
+        [[nodiscard]] const char *what( ) const noexcept override
+        {
+            return message.c_str( );
+        }
+
+    private:
+        std::string message;
+    };
+
     class BaseParser
     {
     public:
         BaseParser( std::string s, long o );
+        BaseParser( std::shared_ptr<InputSource> source, long o );
         ~BaseParser( ) = default;
 
         auto parse_double( ) -> double;
 
         auto parse_int( ) -> int;
 
-        auto is_whitespace( char c ) -> bool;
+        static auto inline is_class( char c, CharClass cls ) -> bool
+        {
+            return ( char_classes[ static_cast<unsigned char>( c ) ] & std::to_underlying( cls ) ) != 0;
+        }
 
-        auto is_delimiter( char c ) -> bool;
+        static auto inline is_whitespace( char c ) -> bool
+        {
+            return is_class( c, CharClass::Whitespace );
+        }
 
-        auto inline is_digit( char c ) -> bool
+        static auto inline is_delimiter( char c ) -> bool
         {
-            return c >= '0' && c <= '9';
+            return is_class( c, CharClass::Delimiter );
         }
 
-        auto inline is_digit_plus_minus( char c ) -> bool
+        static auto inline is_digit( char c ) -> bool
         {
-            return ( c >= '0' && c <= '9' ) || c == '+' || c == '-';
+            return is_class( c, CharClass::Digit );
         }
 
-        auto inline is_digit_plus_minus_dot( char c ) -> bool
+        static auto inline is_digit_plus_minus( char c ) -> bool
         {
-            return ( c >= '0' && c <= '9' ) || c == '+' || c == '-' || c == '.';
+            return is_class( c, CharClass::Digit | CharClass::Sign );
         }
 
-        auto skip_whitespace( ) -> void;
+        static auto inline is_digit_plus_minus_dot( char c ) -> bool
+        {
+            return is_class( c, CharClass::Digit | CharClass::Sign | CharClass::Dot );
+        }
+
+        auto inline skip_whitespace( ) -> void
+        {
+            while ( _offset < _string.length( ) && is_whitespace( _string[ _offset ] ) )
+                _offset++;
+        }
 
         auto skip_comment( ) -> bool;
 
         auto skip_comments_and_whitespaces( ) -> void;
 
-        auto is_keyword( std::string key ) -> bool;
+        /**
+         * @brief consumes key if the input continues with it
+         */
+        auto is_keyword( std::string_view key ) -> bool;
+
+        /**
+         * @brief position of the next occurrence of key at or after from, npos if there is none. candidates for the
+         * first character are found with memchr, which is vectorized by the c library.
+         */
+        [[nodiscard]] auto find( std::string_view key, std::size_t from ) const -> std::size_t;
+
+        /**
+         * @brief position of the last occurrence of key, searched backwards from the end of the input
+         */
+        [[nodiscard]] auto rfind( std::string_view key ) const -> std::size_t;
 
         auto advance( ) -> void
         {
@@ -55,12 +143,8 @@ namespace vrock::pdf
             return _string[ _offset ];
         }
 
-        std::string _string;
+        std::shared_ptr<InputSource> _source;
+        std::string_view _string;
         size_t _offset = 0;
-
-    protected:
-        const std::vector<char> _whitespace = { '\0', '\t', '\n', '\f', '\r', ' ' };
-        const std::vector<char> _endOfLine = { '\n', /* '\r' */ };
-        const std::vector<char> _delimiter = { '<', '>', '(', ')', '[', ']', '{', '}', '/', '%' };
     };
 } // namespace vrock::pdf
\ No newline at end of file
@@ -7,11 +7,15 @@
 #include "vrock/pdf/structure/Rectangle.hpp"
 #include "vrock/pdf/structure/RenderableObject.hpp"
 
+#include <vrock/utils/Generator.hpp>
+
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -190,48 +194,28 @@ namespace vrock::pdf
         /// @brief Move to next line and show text (')
         NextLine,
         /// @brief Set word and character spacing, move to next line, and show text (")
-        SpacingNextLineShowText
+        SpacingNextLineShowText,
+        /// @brief operator not defined in the specification
+        Unknown
     };
 
-    inline std::unordered_map<std::string, ContentStreamOperator> string_to_operator = {
-        { "b", ContentStreamOperator::b },        { "B", ContentStreamOperator::B },
-        { "b*", ContentStreamOperator::bs },      { "B*", ContentStreamOperator::Bs },
-        { "BDC", ContentStreamOperator::BDC },    { "BI", ContentStreamOperator::BI },
-        { "BMC", ContentStreamOperator::BMC },    { "BT", ContentStreamOperator::BT },
-        { "BX", ContentStreamOperator::BX },      { "c", ContentStreamOperator::c },
-        { "cm", ContentStreamOperator::cm },      { "CS", ContentStreamOperator::CS },
-        { "cs", ContentStreamOperator::cs },      { "d", ContentStreamOperator::d },
-        { "d0", ContentStreamOperator::d0 },      { "d1", ContentStreamOperator::d1 },
-        { "Do", ContentStreamOperator::Do },      { "DP", ContentStreamOperator::DP },
-        { "EI", ContentStreamOperator::EI },      { "EMC", ContentStreamOperator::EMC },
-        { "ET", ContentStreamOperator::ET },      { "EX", ContentStreamOperator::EX },
-        { "f", ContentStreamOperator::f },        { "F", ContentStreamOperator::F },
-        { "f*", ContentStreamOperator::fs },      { "G", ContentStreamOperator::G },
-        { "g", ContentStreamOperator::g },        { "gs", ContentStreamOperator::gs },
-        { "h", ContentStreamOperator::h },        { "i", ContentStreamOperator::i },
-        { "ID", ContentStreamOperator::ID },      { "j", ContentStreamOperator::j },
-        { "J", ContentStreamOperator::J },        { "k", ContentStreamOperator::k },
-        { "l", ContentStreamOperator::l },        { "m", ContentStreamOperator::m },
-        { "M", ContentStreamOperator::M },        { "MP", ContentStreamOperator::MP },
-        { "n", ContentStreamOperator::n },        { "q", ContentStreamOperator::q },
-        { "Q", ContentStreamOperator::Q },        { "re", ContentStreamOperator::re },
-        { "RG", ContentStreamOperator::RG },      { "rg", ContentStreamOperator::rg },
-        { "ri", ContentStreamOperator::ri },      { "s", ContentStreamOperator::s },
-        { "S", ContentStreamOperator::S },        { "SC", ContentStreamOperator::SC },
-        { "sc", ContentStreamOperator::sc },      { "SCN", ContentStreamOperator::SCN },
-        { "scn", ContentStreamOperator::scn },    { "sh", ContentStreamOperator::sh },
-        { "T*", ContentStreamOperator::Tst },     { "Tc", ContentStreamOperator::Tc },
-        { "Td", ContentStreamOperator::Td },      { "TD", ContentStreamOperator::TD },
-        { "Tf", ContentStreamOperator::Tf },      { "Tj", ContentStreamOperator::Tj },
-        { "TJ", ContentStreamOperator::TJ },      { "TL", ContentStreamOperator::TL },
-        { "Tm", ContentStreamOperator::Tm },      { "Tr", ContentStreamOperator::Tr },
-        { "Ts", ContentStreamOperator::Ts },      { "Tw", ContentStreamOperator::Tw },
-        { "Tz", ContentStreamOperator::Tz },      { "v", ContentStreamOperator::v },
-        { "w", ContentStreamOperator::w },        { "W", ContentStreamOperator::W },
-        { "W*", ContentStreamOperator::Ws },      { "y", ContentStreamOperator::y },
-        { "'", ContentStreamOperator::NextLine }, { "\"", ContentStreamOperator::SpacingNextLineShowText }
+    inline constexpr std::size_t operator_count = static_cast<std::size_t>( ContentStreamOperator::Unknown ) + 1;
+
+    /**
+     * @brief spelling of the operators, indexed by ContentStreamOperator
+     */
+    inline constexpr std::array<std::string_view, operator_count> operator_names = {
+        "b", "B", "b*", "B*", "BDC", "BI", "BMC", "BT", "BX", "c", "cm", "CS", "cs", "d", "d0", "d1", "Do", "DP", "EI",
+        "EMC", "ET", "EX", "f", "F", "f*", "G", "g", "gs", "h", "i", "ID", "j", "J", "k", "l", "m", "M", "MP", "n",
+        "q", "Q", "re", "RG", "rg", "ri", "s", "S", "SC", "sc", "SCN", "scn", "sh", "T*", "Tc", "Td", "TD", "Tf", "Tj",
+        "TJ", "TL", "Tm", "Tr", "Ts", "Tw", "Tz", "v", "w", "W", "W*", "y", "'", "\"", ""
     };
 
+    /**
+     * @brief decodes an operator with a switch over its packed characters, Unknown if it is not an operator
+     */
+    auto decode_operator( std::string_view op ) -> ContentStreamOperator;
+
     class PDFOperator : public PDFBaseObject
     {
     public:
@@ -240,12 +224,147 @@ namespace vrock::pdf
 
         std::vector<std::shared_ptr<PDFBaseObject>> paramteres = { };
         std::string _operator;
-        ContentStreamOperator o;
+        ContentStreamOperator o = ContentStreamOperator::Unknown;
     };
 
     template <>
     auto to_object_type<PDFOperator>( ) -> PDFObjectType;
 
+    /**
+     * @brief operand of a compiled operator. numbers and names are stored inline in the program, all other operands
+     * as objects
+     */
+    struct ContentOperand
+    {
+        enum class Kind : std::uint8_t
+        {
+            Number,
+            Name,
+            Object
+        };
+
+        Kind kind;
+        /// @brief index into numbers, names or objects of the program depending on kind
+        std::uint32_t index;
+    };
+
+    struct ContentInstruction
+    {
+        ContentStreamOperator op;
+        /// @brief index of the first operand in the operands of the program
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    /**
+     * @brief content stream compiled into a flat list of instructions. it can be executed multiple times without
+     * lexing the content stream again.
+     */
+    class ContentProgram
+    {
+    public:
+        std::vector<ContentInstruction> instructions = { };
+        std::vector<ContentOperand> operands = { };
+        std::vector<double> numbers = { };
+        std::vector<std::string> names = { };
+        std::vector<std::shared_ptr<PDFBaseObject>> objects = { };
+
+        auto clear( ) -> void
+        {
+            instructions.clear( );
+            operands.clear( );
+            numbers.clear( );
+            names.clear( );
+            objects.clear( );
+        }
+    };
+
+    /**
+     * @brief compiles content stream data, comments are dropped and operands after the last operator are ignored
+     */
+    auto compile_content( std::string data, std::shared_ptr<PDFContext> ctx ) -> std::shared_ptr<ContentProgram>;
+
+    /**
+     * @brief compiles the content streams of a page or form in place, without concatenating them first
+     */
+    auto compile_content( const std::vector<std::shared_ptr<PDFStream>> &streams, std::shared_ptr<PDFContext> ctx )
+        -> std::shared_ptr<ContentProgram>;
+
+    /**
+     * @brief the operands of a single instruction
+     */
+    class ContentOperands
+    {
+    public:
+        ContentOperands( const ContentProgram &program, const ContentInstruction &instruction )
+            : program( program ), instruction( instruction )
+        {
+        }
+
+        [[nodiscard]] auto op( ) const -> ContentStreamOperator
+        {
+            return instruction.op;
+        }
+
+        [[nodiscard]] auto size( ) const -> std::size_t
+        {
+            return instruction.count;
+        }
+
+        [[nodiscard]] auto kind( std::size_t idx ) const -> ContentOperand::Kind
+        {
+            return operand( idx ).kind;
+        }
+
+        /**
+         * @brief the number at idx, throws if the operand is not a number
+         */
+        [[nodiscard]] auto number( std::size_t idx ) const -> double
+        {
+            auto &o = operand( idx );
+            if ( o.kind != ContentOperand::Kind::Number )
+                throw PDFParserException( "operand is not a number" );
+            return program.numbers[ o.index ];
+        }
+
+        /**
+         * @brief the name at idx, throws if the operand is not a name
+         */
+        [[nodiscard]] auto name( std::size_t idx ) const -> const std::string &
+        {
+            auto &o = operand( idx );
+            if ( o.kind != ContentOperand::Kind::Name )
+                throw PDFParserException( "operand is not a name" );
+            return program.names[ o.index ];
+        }
+
+        template <typename T>
+            requires std::is_base_of_v<PDFBaseObject, T>
+        [[nodiscard]] auto object( std::size_t idx ) const -> std::shared_ptr<T>
+        {
+            auto &o = operand( idx );
+            if ( o.kind != ContentOperand::Kind::Object )
+                return nullptr;
+            return program.objects[ o.index ]->to<T>( );
+        }
+
+    private:
+        [[nodiscard]] auto operand( std::size_t idx ) const -> const ContentOperand &
+        {
+            return program.operands[ instruction.first + idx ];
+        }
+
+        const ContentProgram &program;
+        const ContentInstruction &instruction;
+    };
+
+    /**
+     * @brief lexes the content streams one after another and yields every operator as soon as it is complete. the
+     * yielded operands are only valid until the generator is resumed.
+     */
+    auto stream_content( std::vector<std::shared_ptr<PDFStream>> streams, std::shared_ptr<PDFContext> ctx )
+        -> utils::Generator<const ContentOperands &>;
+
     // struct GraphicStateParameter
     // {
     //     double line_width = 0.0;
@@ -344,19 +463,67 @@ namespace vrock::pdf
     class ContentStreamParser : public PDFObjectParser
     {
     public:
+        /**
+         * @brief compiles and executes data
+         */
         ContentStreamParser( std::string data, std::shared_ptr<ResourceDictionary> res_dict,
                              std::shared_ptr<PDFContext> ctx );
 
+        /**
+         * @brief only compiles, see compile( ) and next_instruction( )
+         */
+        ContentStreamParser( std::string data, std::shared_ptr<PDFContext> ctx );
+
+        ContentStreamParser( std::shared_ptr<InputSource> source, std::shared_ptr<PDFContext> ctx );
+
+        /**
+         * @brief interpreter without input, see interpret( )
+         */
+        ContentStreamParser( std::shared_ptr<ResourceDictionary> res_dict, std::shared_ptr<PDFContext> ctx );
+
+        /**
+         * @brief executes an already compiled content stream
+         */
+        ContentStreamParser( std::shared_ptr<const ContentProgram> program,
+                             std::shared_ptr<ResourceDictionary> res_dict, std::shared_ptr<PDFContext> ctx );
+
         auto parse_object( std::shared_ptr<PDFRef> ref = nullptr, bool decrypt = false )
             -> std::shared_ptr<PDFBaseObject>;
 
         auto parse_operator( ) -> std::shared_ptr<PDFOperator>;
 
+        /**
+         * @brief compiles the content stream from the current offset to the end
+         */
+        auto compile( ) -> std::shared_ptr<ContentProgram>;
+
+        /**
+         * @brief lexes operands into program until the next operator is complete and appends it to the
+         * instructions. operands following the last operator stay in program.
+         * @return false if the end of the input was reached without an operator
+         */
+        auto next_instruction( ContentProgram &program ) -> bool;
+
+        /**
+         * @brief executes the operators of streams while they are lexed
+         * @param stop checked after every operator, interpretation ends once it returns true
+         */
+        auto interpret( const std::vector<std::shared_ptr<PDFStream>> &streams,
+                        const std::function<bool( )> &stop = nullptr ) -> void;
+
+        auto execute( const ContentProgram &program ) -> void;
+
         utils::List<std::shared_ptr<Image>> images = { };
         utils::List<std::shared_ptr<Text>> text = { };
 
     private:
-        auto to_operator_array( ) -> std::vector<std::shared_ptr<PDFOperator>>;
+        auto lex_operator( ) -> std::string_view;
+
+        /**
+         * @brief runs a single operator
+         * @return false if the operator failed, which ends the interpretation
+         */
+        auto execute( const ContentOperands &op ) -> bool;
 
     public:
         std::shared_ptr<ResourceDictionary> res;
@@ -364,44 +531,49 @@ namespace vrock::pdf
     };
 
     // operator functions
-    // void operator_b( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-
-    void operator_cm( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-
-    void operator_Do( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-
-    void operator_gs( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-
-    void operator_q( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-    void operator_Q( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-
-    void operator_Tc( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-
-    void operator_Tf( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-    void operator_Tj( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-    void operator_TJ( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-    void operator_TL( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-
-    void operator_Tw( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-    void operator_Tz( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-    void operator_v( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-    void operator_w( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-    void operator_W( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-    void operator_Ws( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-    void operator_y( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-    void operator_NL( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-    void operator_SNLST( ContentStreamParser *, std::shared_ptr<PDFOperator> op );
-
-    inline std::unordered_map<ContentStreamOperator,
-                              std::function<void( ContentStreamParser *, std::shared_ptr<PDFOperator> )>>
-        operator_fn = {
-            { ContentStreamOperator::cm, operator_cm }, { ContentStreamOperator::Do, operator_Do },
-            { ContentStreamOperator::gs, operator_gs }, { ContentStreamOperator::q, operator_q },
-            { ContentStreamOperator::Q, operator_Q },   { ContentStreamOperator::Tf, operator_Tf },
-            { ContentStreamOperator::Tc, operator_Tc }, { ContentStreamOperator::Tj, operator_Tj },
-            { ContentStreamOperator::TJ, operator_TJ }, { ContentStreamOperator::TL, operator_TL },
-            { ContentStreamOperator::Tw, operator_Tw }, { ContentStreamOperator::Tz, operator_Tz },
-            { ContentStreamOperator::w, operator_w },
-        };
+    using operator_fn_t = void ( * )( ContentStreamParser *, const ContentOperands & );
 
+    void operator_cm( ContentStreamParser *, const ContentOperands &op );
+
+    void operator_Do( ContentStreamParser *, const ContentOperands &op );
+
+    void operator_gs( ContentStreamParser *, const ContentOperands &op );
+
+    void operator_q( ContentStreamParser *, const ContentOperands &op );
+    void operator_Q( ContentStreamParser *, const ContentOperands &op );
+
+    void operator_Tc( ContentStreamParser *, const ContentOperands &op );
+
+    void operator_Tf( ContentStreamParser *, const ContentOperands &op );
+    void operator_Tj( ContentStreamParser *, const ContentOperands &op );
+    void operator_TJ( ContentStreamParser *, const ContentOperands &op );
+    void operator_TL( ContentStreamParser *, const ContentOperands &op );
+
+    void operator_Tw( ContentStreamParser *, const ContentOperands &op );
+    void operator_Tz( ContentStreamParser *, const ContentOperands &op );
+    void operator_w( ContentStreamParser *, const ContentOperands &op );
+
+    /**
+     * @brief operator functions indexed by ContentStreamOperator, nullptr for operators without effect
+     */
+    inline constexpr std::array<operator_fn_t, operator_count> operator_table = [] {
+        std::array<operator_fn_t, operator_count> table{ };
+        auto set = [ &table ]( ContentStreamOperator op, operator_fn_t fn ) {
+            table[ static_cast<std::size_t>( op ) ] = fn;
+        };
+        set( ContentStreamOperator::cm, operator_cm );
+        set( ContentStreamOperator::Do, operator_Do );
+        set( ContentStreamOperator::gs, operator_gs );
+        set( ContentStreamOperator::q, operator_q );
+        set( ContentStreamOperator::Q, operator_Q );
+        set( ContentStreamOperator::Tf, operator_Tf );
+        set( ContentStreamOperator::Tc, operator_Tc );
+        set( ContentStreamOperator::Tj, operator_Tj );
+        set( ContentStreamOperator::TJ, operator_TJ );
+        set( ContentStreamOperator::TL, operator_TL );
+        set( ContentStreamOperator::Tw, operator_Tw );
+        set( ContentStreamOperator::Tz, operator_Tz );
+        set( ContentStreamOperator::w, operator_w );
+        return table;
+    }( );
 } // namespace vrock::pdf
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "vrock/pdf/typedefs.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+namespace vrock::pdf
+{
+    /**
+     * @brief read-only bytes a parser operates on. the view stays valid as long as the source is alive.
+     */
+    class InputSource
+    {
+    public:
+        InputSource( ) = default;
+        virtual ~InputSource( ) = default;
+
+        InputSource( const InputSource & ) = delete;
+        auto operator=( const InputSource & ) -> InputSource & = delete;
+
+        [[nodiscard]] virtual auto view( ) const -> in_data_t = 0;
+    };
+
+    /**
+     * @brief input source owning its data in memory
+     */
+    class StringInputSource : public InputSource
+    {
+    public:
+        explicit StringInputSource( data_t d );
+
+        [[nodiscard]] auto view( ) const -> in_data_t final;
+
+    private:
+        data_t data;
+    };
+
+    /**
+     * @brief input source viewing memory of another object, which is kept alive by the source
+     */
+    class ViewInputSource : public InputSource
+    {
+    public:
+        ViewInputSource( in_data_t d, std::shared_ptr<const void> owner );
+
+        [[nodiscard]] auto view( ) const -> in_data_t final;
+
+    private:
+        in_data_t data;
+        std::shared_ptr<const void> owner;
+    };
+
+    /**
+     * @brief input source backed by a read-only memory mapping of a file
+     */
+    class MappedFileInputSource : public InputSource
+    {
+    public:
+        explicit MappedFileInputSource( const std::filesystem::path &path );
+        ~MappedFileInputSource( ) override;
+
+        [[nodiscard]] auto view( ) const -> in_data_t final;
+
+    private:
+        const char *data = nullptr;
+        std::size_t size = 0;
+#if defined( _WIN32 )
+        void *file = nullptr;
+        void *mapping = nullptr;
+#endif
+    };
+
+    /**
+     * @brief reads the whole file into memory with a single allocation, which is followed by 8 zeroed slack bytes
+     */
+    auto read_file( const std::filesystem::path &path ) -> std::shared_ptr<InputSource>;
+
+    /**
+     * @brief maps the file into memory. falls back to read_file if the mapping would not be followed by
+     * 8 zeroed slack bytes like read_file, which the parsers rely on when peeking past the end of the input.
+     */
+    auto map_file( const std::filesystem::path &path ) -> std::shared_ptr<InputSource>;
+} // namespace vrock::pdf
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "BaseParser.hpp"
 
 #include "vrock/pdf/structure/PDFContext.hpp"
+#include "vrock/pdf/structure/PDFObjectArena.hpp"
 #include "vrock/pdf/structure/PDFObjects.hpp"
 #include "vrock/pdf/structure/PDFStreams.hpp"
 
@@ -11,6 +12,11 @@
 #include <utility>
 #include <vector>
 
+namespace vrock::utils
+{
+    class ThreadPool;
+}
+
 namespace vrock::pdf
 {
     class PDFBaseSecurityHandler;
@@ -20,6 +26,7 @@ namespace vrock::pdf
     public:
         PDFObjectParser( );
         explicit PDFObjectParser( std::string s );
+        explicit PDFObjectParser( std::shared_ptr<InputSource> source );
 
         auto parse_object( std::shared_ptr<PDFRef> ref, bool decrypt ) -> std::shared_ptr<PDFBaseObject>; // TODO: Test
         auto parse_dictionary( std::shared_ptr<PDFRef> ref, bool decrypt ) -> std::shared_ptr<PDFDictionary>;
@@ -34,6 +41,21 @@ namespace vrock::pdf
 
         auto parse_xref( std::size_t offset = -1 ) -> std::vector<std::shared_ptr<XRefTable>>;
 
+        /**
+         * @brief parses the cross-reference sections like parse_xref, large classic subsections are decoded on the pool
+         */
+        auto parse_xref( utils::ThreadPool &pool, std::size_t offset = -1 ) -> std::vector<std::shared_ptr<XRefTable>>;
+
+        /**
+         * @brief offset of the newest cross-reference section given behind the last startxref keyword
+         */
+        auto find_startxref( ) -> std::size_t;
+
+        /**
+         * @brief parses the indirect object at offset with its own cursor, so it can be called concurrently
+         */
+        auto parse_indirect_object( std::size_t offset ) const -> std::shared_ptr<PDFBaseObject>;
+
         auto set_decryption_handler( std::shared_ptr<PDFBaseSecurityHandler> handler ) -> void
         {
             decryption_handler = std::move( handler );
@@ -44,31 +66,30 @@ namespace vrock::pdf
             context = std::move( ctx );
         }
 
+        /**
+         * @brief allocate parsed objects from the arena instead of the heap, streams are always heap allocated
+         */
+        auto set_arena( std::shared_ptr<PDFObjectArena> a ) -> void
+        {
+            arena = std::move( a );
+        }
+
     protected:
-        const std::unordered_map<char, std::string> string_literal_lookup = {
+        static inline const std::unordered_map<char, std::string> string_literal_lookup = {
             { 'n', "\n" }, { 'r', "\r" }, { 't', "\t" },  { 'b', "\b" }, { 'f', "\f" },
             { '(', "(" },  { ')', ")" },  { '\\', "\\" }, { '\n', "" }
         };
 
         std::shared_ptr<PDFContext> context;
         std::shared_ptr<PDFBaseSecurityHandler> decryption_handler;
+        std::shared_ptr<PDFObjectArena> arena;
 
         auto find_end_of_stream( ) -> std::size_t;
-    };
-
-    class PDFParserException : public std::exception
-    {
-    public:
-        explicit PDFParserException( std::string m ) : message( std::move( m ) )
-        {
-        }
-
-        [[nodiscard]] const char *what( ) const noexcept override
-        {
-            return message.c_str( );
-        }
 
-    private:
-        std::string message;
+        // without a pool every subsection is decoded on the calling thread
+        auto parse_xref_chain( std::size_t offset, utils::ThreadPool *pool ) -> std::vector<std::shared_ptr<XRefTable>>;
+        auto parse_xref_section( std::size_t offset, utils::ThreadPool *pool ) -> std::shared_ptr<XRefTable>;
+        auto parse_xref_subsection( XRefTable &table, std::uint32_t start, std::uint32_t amount,
+                                    utils::ThreadPool *pool ) -> void;
     };
 } // namespace vrock::pdf
\ No newline at end of file
@@ -1,9 +1,15 @@
 #pragma once
 
+#include "PDFObjectCache.hpp"
 #include "PDFObjects.hpp"
 
 #include <vrock/utils/List.hpp>
 
+namespace vrock::utils
+{
+    class ThreadPool;
+}
+
 namespace vrock::pdf
 {
     class PDFObjectParser;
@@ -14,33 +20,58 @@ namespace vrock::pdf
         XRefEntry( ) = default;
         XRefEntry( std::uint32_t offset, std::uint32_t object_number, std::uint32_t gen_num, std::uint8_t type );
 
+        // marks slots of an XRefTable that are not present in the table
+        static constexpr std::uint8_t missing = 0xFF;
+        // implementation limit for indirect objects in ISO 32000
+        static constexpr std::uint32_t max_object_number = 8388607;
+
         std::uint32_t offset = 0;
         std::uint32_t object_number = 0;
         std::uint32_t generation_number = 0;
         std::uint8_t type = 0;
     };
 
-    struct XRefEntryPtrHash
-    {
-    public:
-        size_t operator( )( const std::shared_ptr<XRefEntry> &r ) const;
-    };
-
-    struct XRefEntryPtrEqual
-    {
-        bool operator( )( const std::shared_ptr<XRefEntry> &l, const std::shared_ptr<XRefEntry> &r ) const;
-    };
-
     class XRefTable
     {
     public:
         XRefTable( ) = default;
 
-        auto get_entry( const std::shared_ptr<PDFRef> &ref ) -> std::shared_ptr<XRefEntry>;
+        /**
+         * @brief returns the entry for the object number or nullptr if this table does not contain it
+         */
+        auto get_entry( std::uint32_t object_number ) const -> const XRefEntry *
+        {
+            if ( object_number >= entries.size( ) || entries[ object_number ].type == XRefEntry::missing )
+                return nullptr;
+            return &entries[ object_number ];
+        }
+
+        auto set_entry( const XRefEntry &entry ) -> void;
+
+        /**
+         * @brief makes room for object numbers below size, so adding them does not reallocate
+         */
+        auto reserve( std::size_t size ) -> void;
 
-        std::unordered_map<std::shared_ptr<XRefEntry>, std::shared_ptr<XRefEntry>, XRefEntryPtrHash, XRefEntryPtrEqual>
-            entries = { };
+        /**
+         * @brief adds all entries of a newer table, overriding existing ones
+         */
+        auto merge( const XRefTable &newer ) -> void;
+
+        /**
+         * @brief number of entries present in the table
+         */
+        auto size( ) const -> std::size_t
+        {
+            return count;
+        }
+
+        // indexed by object number
+        std::vector<XRefEntry> entries = { };
         std::shared_ptr<PDFDictionary> trailer;
+
+    private:
+        std::size_t count = 0;
     };
 
     class PDFContext
@@ -52,6 +83,43 @@ namespace vrock::pdf
 
         auto init( ) -> void;
 
+        /**
+         * @brief reads the cross-reference sections like init, large classic subsections are decoded on the pool
+         */
+        auto init( utils::ThreadPool &pool ) -> void;
+
+        /**
+         * @brief decodes all object streams referenced by the XRef table on the pool and indexes their objects. the
+         * streams stay in the cache unless pinning of object streams is disabled. encrypted documents have to be
+         * authenticated first.
+         * @return number of object streams
+         */
+        auto prefetch_object_streams( utils::ThreadPool &pool ) -> std::size_t;
+
+        /**
+         * @brief adds a new indirect object to the document, it is written by the next save
+         */
+        auto add_object( std::shared_ptr<PDFBaseObject> obj ) -> std::shared_ptr<PDFRef>;
+
+        /**
+         * @brief marks a resolved indirect object as modified and keeps it cached. changes made through
+         * PDFDictionary::set and PDFString::set are detected without it.
+         */
+        auto mark_modified( const std::shared_ptr<PDFRef> &ref ) -> void;
+
+        /**
+         * @brief indirect objects that were added, marked or contain objects changed through set since the document
+         * was opened or last appended to, ordered by object number
+         */
+        auto get_modified_objects( ) -> std::vector<std::pair<std::shared_ptr<PDFRef>, std::shared_ptr<PDFBaseObject>>>;
+
+        /**
+         * @brief called once the modified objects are appended to the file. they are pinned in the cache, because the
+         * parser can not read them from the original source.
+         * @param offset offset of the appended cross-reference section
+         */
+        auto clear_modified( std::size_t offset ) -> void;
+
         template <typename T>
             requires std::is_base_of_v<PDFBaseObject, T>
         auto get_object( const std::shared_ptr<PDFRef> &ref ) -> std::shared_ptr<T>
@@ -60,10 +128,21 @@ namespace vrock::pdf
         }
 
         std::shared_ptr<PDFObjectParser> parser;
-        std::unordered_map<std::shared_ptr<PDFRef>, std::shared_ptr<PDFBaseObject>, PDFRefPtrHash, PDFRefPtrEqual>
-            objects = { };
+        PDFObjectCache cache;
 
         std::shared_ptr<PDFDictionary> trailer;
+        // newest table first
         std::vector<std::shared_ptr<XRefTable>> xref_tables;
+        // all tables merged, used for lookups
+        XRefTable xref;
+        // offset of the newest cross-reference section
+        std::size_t startxref = 0;
+        // smallest object number that is not used by the document
+        std::uint32_t next_object_number = 1;
+
+    private:
+        auto init_tables( std::vector<std::shared_ptr<XRefTable>> tables ) -> void;
+
+        std::vector<std::shared_ptr<PDFRef>> marked;
     };
 } // namespace vrock::pdf
\ No newline at end of file
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
 
 #include "PDFObjects.hpp"
 
@@ -134,10 +137,28 @@ namespace vrock::pdf
         auto has_permission( Permissions perm ) -> bool override;
 
     private:
+        /**
+         * @brief key of the object ref for revisions 2 to 4, recently used keys are not derived again. It is returned
+         * by value, because the slot may be reused while another thread still uses the key
+         */
+        auto get_object_key( const std::shared_ptr<PDFRef> &ref ) -> data_t;
+        auto set_key( data_t k ) -> void;
+
         std::shared_ptr<PDFContext> context;
 
         std::shared_ptr<PDFDictionary> dict;
         data_t key;
+        struct ObjectKey
+        {
+            // object number << 32 | generation number
+            std::uint64_t id = std::numeric_limits<std::uint64_t>::max( );
+            data_t key;
+        };
+
+        // keys of recently decrypted objects, slot by object number so the cache does not grow with the document.
+        // objects may be decrypted on multiple threads
+        std::mutex object_keys_mutex;
+        std::array<ObjectKey, 256> object_keys;
         AuthenticationState state = AuthenticationState::Failed;
         std::uint32_t permissions;
         std::uint8_t revision;
@@ -1,21 +1,49 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
 
 #include "vrock/pdf/typedefs.hpp"
 
+namespace vrock::utils
+{
+    class ThreadPool;
+}
+
 namespace vrock::pdf
 {
     class PDFDictionary;
 
+    using consumer_t = std::function<void( in_data_t )>;
+
+    // streams of at least this size are compressed on the thread pool of a PDFFlateFilter
+    constexpr std::size_t parallel_flate_threshold = 1024 * 1024;
+
     class BaseFilter
     {
     public:
         virtual auto encode( in_data_t, std::shared_ptr<PDFDictionary> ) -> data_t = 0;
 
         virtual auto decode( in_data_t, std::shared_ptr<PDFDictionary> ) -> data_t = 0;
+
+        /**
+         * @brief decode with the expected decoded length, e.g. from the /DL entry of the stream
+         */
+        virtual auto decode( in_data_t data, std::shared_ptr<PDFDictionary> params, std::size_t ) -> data_t
+        {
+            return decode( data, std::move( params ) );
+        }
+
+        /**
+         * @brief decode and hand the decoded data to consumer, possibly in multiple chunks
+         */
+        virtual auto decode_to( in_data_t data, std::shared_ptr<PDFDictionary> params, const consumer_t &consumer )
+            -> void
+        {
+            consumer( decode( data, std::move( params ) ) );
+        }
     };
 
     class PDFASCIIFilter : public BaseFilter
@@ -29,9 +57,29 @@ namespace vrock::pdf
     class PDFFlateFilter : public BaseFilter
     {
     public:
+        /**
+         * @param level compression level used by encode from 0 to 9, -1 selects zlib's default level
+         * @param parallel_threshold encode splits data of at least this size into blocks compressed on the pool
+         * @param pool compresses large data in parallel, without a pool encode compresses on the calling thread
+         */
+        explicit PDFFlateFilter( int level = -1, std::size_t parallel_threshold = parallel_flate_threshold,
+                                 std::shared_ptr<utils::ThreadPool> pool = nullptr )
+            : level( level ), parallel_threshold( parallel_threshold ), pool( std::move( pool ) )
+        {
+        }
+
         auto encode( in_data_t, std::shared_ptr<PDFDictionary> ) -> data_t final;
 
         auto decode( in_data_t, std::shared_ptr<PDFDictionary> ) -> data_t final;
+
+        auto decode( in_data_t, std::shared_ptr<PDFDictionary>, std::size_t size_hint ) -> data_t final;
+
+        auto decode_to( in_data_t, std::shared_ptr<PDFDictionary>, const consumer_t &consumer ) -> void final;
+
+    private:
+        int level;
+        std::size_t parallel_threshold;
+        std::shared_ptr<utils::ThreadPool> pool;
     };
 
     class PDFDCTFilter : public BaseFilter
@@ -39,14 +87,23 @@ namespace vrock::pdf
     public:
         auto encode( in_data_t, std::shared_ptr<PDFDictionary> ) -> data_t final;
 
+        /**
+         * @brief decodes a JPEG into 8 bit gray or RGB samples. ColorTransform of params is honoured unless the image
+         * has an Adobe marker, CMYK and YCCK images are converted to RGB.
+         */
         auto decode( in_data_t, std::shared_ptr<PDFDictionary> ) -> data_t final;
     };
 
+    /**
+     * @brief reverses the PNG predictors (predictor values 10 to 15), each row selects its own filter type. throws
+     * for parameters that are not positive or a row that is longer than data.
+     */
+    auto predict_png( in_data_t data, int columns, int colors, int bpc ) -> data_t;
+
     inline std::unordered_map<std::string, std::shared_ptr<BaseFilter>> encodings = {
         { "ASCIIHexDecode", std::make_shared<PDFASCIIFilter>( ) },
         { "FlateDecode", std::make_shared<PDFFlateFilter>( ) },
-        // TODO: implement JPXDecode and DCTDecode correctly
+        // TODO: implement JPXDecode
         { "DCTDecode", std::make_shared<PDFDCTFilter>( ) },
-        { "JPXDecode", std::make_shared<PDFDCTFilter>( ) },
     };
 } // namespace vrock::pdf
\ No newline at end of file
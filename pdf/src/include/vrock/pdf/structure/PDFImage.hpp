@@ -8,7 +8,9 @@ namespace vrock::pdf
 {
     enum class ImageSaveFormat
     {
-        png
+        png,
+        // DCT encoded images are written as they are stored in the document without decoding them
+        jpeg
     };
 
     class PDFImage
@@ -33,11 +35,19 @@ namespace vrock::pdf
             return bpp;
         }
 
-        inline auto as_rgb( ) -> data_t
+        /**
+         * @brief true if the image is stored as JPEG, which can be saved without decoding it
+         */
+        inline auto is_jpeg( ) const -> bool
         {
-            return color_space->convert_to_rgb( data_t( stream->data ), stream->dict );
+            return !stream->filters.empty( ) && stream->filters.back( ) == "DCTDecode";
         }
 
+        /**
+         * @brief decoded pixels as RGB, throws for JPXDecode images because there is no JPEG 2000 decoder
+         */
+        auto as_rgb( ) -> data_t;
+
         auto as_rgba( ) -> data_t;
 
     private:
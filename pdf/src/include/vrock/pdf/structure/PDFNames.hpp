@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace vrock::pdf
+{
+    /**
+     * @brief id of a well-known name, 0 for all other names
+     */
+    using PDFNameId = std::uint32_t;
+
+    namespace names
+    {
+        // sorted, the position is the id of the name
+        inline constexpr std::array<std::string_view, 84> well_known = {
+            "", "AcroForm", "Annots", "ArtBox", "BBox", "BaseFont", "BitsPerComponent", "BitsPerSample", "BleedBox",
+            "CF", "CFM", "Catalog", "ColorSpace", "ColorTransform", "Colors", "Columns", "Contents", "Count",
+            "CropBox", "DL", "Decode", "DecodeParms", "Domain", "Encode", "Encoding", "Encrypt", "EncryptMetadata",
+            "ExtGState", "Filter", "First", "FirstChar", "FlateDecode", "Font", "FontDescriptor", "Form",
+            "FunctionType", "Functions", "Height", "ID", "Image", "Index", "Info", "Kids", "LastChar", "Length",
+            "Length1", "Length2", "Length3", "MediaBox", "N", "Name", "O", "OE", "ObjStm", "P", "Page", "Pages",
+            "Parent", "Pattern", "Perms", "Predictor", "Prev", "ProcSet", "R", "Range", "Resources", "Root", "Rotate",
+            "Shading", "Size", "StdCF", "Subtype", "ToUnicode", "TrimBox", "Type", "U", "UE", "V", "W", "Width",
+            "Widths", "XObject", "XRef", "XRefStm"
+        };
+
+        constexpr auto find( std::string_view name ) -> PDFNameId
+        {
+            // binary search, the empty name at index 0 is not a well-known name
+            std::size_t lo = 1, hi = well_known.size( );
+            while ( lo < hi )
+            {
+                auto mid = ( lo + hi ) / 2;
+                if ( well_known[ mid ] < name )
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return lo < well_known.size( ) && well_known[ lo ] == name ? static_cast<PDFNameId>( lo ) : 0;
+        }
+
+        consteval auto id( std::string_view name ) -> PDFNameId
+        {
+            if ( find( name ) == 0 )
+                throw "not a well-known name";
+            return find( name );
+        }
+
+        inline constexpr PDFNameId ArtBox = id( "ArtBox" );
+        inline constexpr PDFNameId BBox = id( "BBox" );
+        inline constexpr PDFNameId BaseFont = id( "BaseFont" );
+        inline constexpr PDFNameId BitsPerComponent = id( "BitsPerComponent" );
+        inline constexpr PDFNameId BleedBox = id( "BleedBox" );
+        inline constexpr PDFNameId Colors = id( "Colors" );
+        inline constexpr PDFNameId Columns = id( "Columns" );
+        inline constexpr PDFNameId Contents = id( "Contents" );
+        inline constexpr PDFNameId Count = id( "Count" );
+        inline constexpr PDFNameId CropBox = id( "CropBox" );
+        inline constexpr PDFNameId DL = id( "DL" );
+        inline constexpr PDFNameId DecodeParms = id( "DecodeParms" );
+        inline constexpr PDFNameId Encrypt = id( "Encrypt" );
+        inline constexpr PDFNameId ExtGState = id( "ExtGState" );
+        inline constexpr PDFNameId Filter = id( "Filter" );
+        inline constexpr PDFNameId First = id( "First" );
+        inline constexpr PDFNameId Font = id( "Font" );
+        inline constexpr PDFNameId ID = id( "ID" );
+        inline constexpr PDFNameId Index = id( "Index" );
+        inline constexpr PDFNameId Info = id( "Info" );
+        inline constexpr PDFNameId Kids = id( "Kids" );
+        inline constexpr PDFNameId Length = id( "Length" );
+        inline constexpr PDFNameId MediaBox = id( "MediaBox" );
+        inline constexpr PDFNameId N = id( "N" );
+        inline constexpr PDFNameId ObjStm = id( "ObjStm" );
+        inline constexpr PDFNameId Page = id( "Page" );
+        inline constexpr PDFNameId Pages = id( "Pages" );
+        inline constexpr PDFNameId Predictor = id( "Predictor" );
+        inline constexpr PDFNameId Prev = id( "Prev" );
+        inline constexpr PDFNameId Resources = id( "Resources" );
+        inline constexpr PDFNameId Root = id( "Root" );
+        inline constexpr PDFNameId Rotate = id( "Rotate" );
+        inline constexpr PDFNameId Size = id( "Size" );
+        inline constexpr PDFNameId Subtype = id( "Subtype" );
+        inline constexpr PDFNameId TrimBox = id( "TrimBox" );
+        inline constexpr PDFNameId Type = id( "Type" );
+        inline constexpr PDFNameId W = id( "W" );
+        inline constexpr PDFNameId XObject = id( "XObject" );
+        inline constexpr PDFNameId XRef = id( "XRef" );
+        inline constexpr PDFNameId XRefStm = id( "XRefStm" );
+    } // namespace names
+
+    /**
+     * @brief key for name lookups that does not allocate. well-known names are compared by id, all other names by
+     * their string.
+     */
+    struct PDFNameKey
+    {
+        constexpr PDFNameKey( PDFNameId i ) : id( i ), name( names::well_known[ i ] )
+        {
+        }
+
+        constexpr PDFNameKey( std::string_view n ) : id( names::find( n ) ), name( n )
+        {
+        }
+
+        constexpr PDFNameKey( const char *n ) : PDFNameKey( std::string_view( n ) )
+        {
+        }
+
+        PDFNameKey( const std::string &n ) : PDFNameKey( std::string_view( n ) )
+        {
+        }
+
+        PDFNameId id;
+        std::string_view name;
+    };
+} // namespace vrock::pdf
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+namespace vrock::pdf
+{
+    /**
+     * @brief monotonic memory for the objects created by one parse. every object allocated from the arena keeps it
+     * alive, so the memory is released once the last of them is destroyed.
+     */
+    class PDFObjectArena
+    {
+    public:
+        explicit PDFObjectArena( std::size_t initial_size = 1024 ) : resource( initial_size )
+        {
+        }
+
+        PDFObjectArena( const PDFObjectArena & ) = delete;
+        auto operator=( const PDFObjectArena & ) -> PDFObjectArena & = delete;
+
+        auto allocate( std::size_t bytes, std::size_t alignment ) -> void *
+        {
+            return resource.allocate( bytes, alignment );
+        }
+
+    private:
+        std::pmr::monotonic_buffer_resource resource;
+    };
+
+    template <class T>
+    class PDFArenaAllocator
+    {
+    public:
+        using value_type = T;
+
+        explicit PDFArenaAllocator( std::shared_ptr<PDFObjectArena> a ) : arena( std::move( a ) )
+        {
+        }
+
+        template <class U>
+        PDFArenaAllocator( const PDFArenaAllocator<U> &other ) : arena( other.arena )
+        {
+        }
+
+        auto allocate( std::size_t n ) -> T *
+        {
+            return static_cast<T *>( arena->allocate( n * sizeof( T ), alignof( T ) ) );
+        }
+
+        auto deallocate( T *, std::size_t ) -> void
+        {
+            // released together with the arena
+        }
+
+        template <class U>
+        auto operator==( const PDFArenaAllocator<U> &other ) const -> bool
+        {
+            return arena == other.arena;
+        }
+
+        std::shared_ptr<PDFObjectArena> arena;
+    };
+
+    /**
+     * @brief creates an object in the arena, or on the heap if no arena is given
+     */
+    template <class T, class... Args>
+    auto make_object( const std::shared_ptr<PDFObjectArena> &arena, Args &&...args ) -> std::shared_ptr<T>
+    {
+        if ( arena )
+            return std::allocate_shared<T>( PDFArenaAllocator<T>( arena ), std::forward<Args>( args )... );
+        return std::make_shared<T>( std::forward<Args>( args )... );
+    }
+} // namespace vrock::pdf
\ No newline at end of file
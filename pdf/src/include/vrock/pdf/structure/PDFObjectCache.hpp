@@ -0,0 +1,106 @@
+#pragma once
+
+#include "PDFObjects.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace vrock::pdf
+{
+    struct PDFCachePolicy
+    {
+        /**
+         * @brief upper bound in bytes for the estimated size of unpinned objects, 0 means unbounded
+         */
+        std::size_t max_size = 0;
+        /**
+         * @brief keep Pages and Page dictionaries cached
+         */
+        bool pin_page_tree = true;
+        /**
+         * @brief keep decoded object streams cached
+         */
+        bool pin_object_streams = true;
+    };
+
+    /**
+     * @brief cache of resolved indirect objects. unpinned objects are evicted in least recently used order once
+     * the policy's size limit is exceeded. evicted objects that are still referenced elsewhere are handed out again
+     * instead of being parsed a second time. all member functions are safe to call concurrently.
+     */
+    class PDFObjectCache
+    {
+    public:
+        explicit PDFObjectCache( PDFCachePolicy policy = { } );
+
+        auto get( const std::shared_ptr<PDFRef> &ref ) -> std::shared_ptr<PDFBaseObject>;
+        auto insert( const std::shared_ptr<PDFRef> &ref, std::shared_ptr<PDFBaseObject> obj, bool pin = false )
+            -> void;
+        /**
+         * @brief inserts the object unless the reference is already cached
+         * @return the cached object
+         */
+        auto insert_or_get( const std::shared_ptr<PDFRef> &ref, std::shared_ptr<PDFBaseObject> obj )
+            -> std::shared_ptr<PDFBaseObject>;
+        auto contains( const std::shared_ptr<PDFRef> &ref ) const -> bool;
+        auto erase( const std::shared_ptr<PDFRef> &ref ) -> void;
+        auto clear( ) -> void;
+
+        auto pin( const std::shared_ptr<PDFRef> &ref ) -> void;
+        auto unpin( const std::shared_ptr<PDFRef> &ref ) -> void;
+
+        /**
+         * @brief calls fn for every cached object and every evicted object that is still alive
+         */
+        auto for_each(
+            const std::function<void( const std::shared_ptr<PDFRef> &, const std::shared_ptr<PDFBaseObject> & )> &fn )
+            -> void;
+
+        auto set_policy( PDFCachePolicy p ) -> void;
+        auto get_policy( ) const -> PDFCachePolicy;
+
+        /**
+         * @brief number of cached objects
+         */
+        auto size( ) const -> std::size_t;
+
+        /**
+         * @brief estimated size in bytes of all unpinned objects
+         */
+        auto byte_size( ) const -> std::size_t;
+
+    private:
+        struct Entry
+        {
+            std::shared_ptr<PDFBaseObject> object;
+            std::size_t size = 0;
+            bool pinned = false;
+            std::list<std::shared_ptr<PDFRef>>::iterator position;
+        };
+
+        auto get_unlocked( const std::shared_ptr<PDFRef> &ref ) -> std::shared_ptr<PDFBaseObject>;
+        auto insert_unlocked( const std::shared_ptr<PDFRef> &ref, std::shared_ptr<PDFBaseObject> obj, bool pin )
+            -> void;
+        auto erase_unlocked( const std::shared_ptr<PDFRef> &ref ) -> void;
+        auto should_pin( const std::shared_ptr<PDFBaseObject> &obj ) const -> bool;
+        auto evict( ) -> void;
+
+        mutable std::mutex mutex;
+        PDFCachePolicy policy;
+        // most recently used unpinned entries are at the front
+        std::list<std::shared_ptr<PDFRef>> lru = { };
+        std::unordered_map<std::shared_ptr<PDFRef>, Entry, PDFRefPtrHash, PDFRefPtrEqual> entries = { };
+        std::unordered_map<std::shared_ptr<PDFRef>, std::weak_ptr<PDFBaseObject>, PDFRefPtrHash, PDFRefPtrEqual>
+            evicted = { };
+        std::size_t current_size = 0;
+    };
+
+    /**
+     * @brief rough estimate of the memory held by an object including its children
+     */
+    auto estimate_size( const std::shared_ptr<PDFBaseObject> &obj ) -> std::size_t;
+} // namespace vrock::pdf
\ No newline at end of file
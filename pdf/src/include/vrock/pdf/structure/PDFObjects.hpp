@@ -1,14 +1,18 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <format>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
 #include <vrock/log.hpp>
 
+#include "vrock/pdf/structure/PDFNames.hpp"
+
 #if defined( __clang__ )
 #define OPTNONE_START [[clang::optnone]]
 #elif defined( __GNUC__ )
@@ -31,6 +35,9 @@ namespace vrock::pdf
     using in_data_t = std::string_view;
 
     class PDFContext;
+    class PDFBaseSecurityHandler;
+    class PDFRef;
+
     enum class PDFObjectType
     {
         None,
@@ -91,6 +98,8 @@ namespace vrock::pdf
         }
 
         const PDFObjectType type = PDFObjectType::None;
+        // set by modifications through set, incremental saves write indirect objects containing modified objects
+        bool modified = false;
     };
 
     class PDFRef : public PDFBaseObject
@@ -131,17 +140,25 @@ namespace vrock::pdf
         bool operator!=( const PDFName &rhs ) const;
 
         std::string name;
+        PDFNameId id;
     };
 
     struct PDFNamePtrHash
     {
     public:
+        using is_transparent = void;
+
         size_t operator( )( const std::shared_ptr<PDFName> &n ) const;
+        size_t operator( )( const PDFNameKey &k ) const;
     };
 
     struct PDFNamePtrEqual
     {
+        using is_transparent = void;
+
         bool operator( )( const std::shared_ptr<PDFName> &l, const std::shared_ptr<PDFName> &r ) const;
+        bool operator( )( const PDFNameKey &l, const std::shared_ptr<PDFName> &r ) const;
+        bool operator( )( const std::shared_ptr<PDFName> &l, const PDFNameKey &r ) const;
     };
 
     class PDFBool : public PDFBaseObject
@@ -215,6 +232,30 @@ namespace vrock::pdf
         double value;
     };
 
+    /**
+     * @brief encrypted data of a string or stream, which is decrypted once when it is accessed the first time
+     */
+    struct PDFEncryptedData
+    {
+        PDFEncryptedData( in_data_t d, std::shared_ptr<const void> o, std::weak_ptr<PDFBaseSecurityHandler> h,
+                          std::shared_ptr<PDFRef> r );
+
+        /**
+         * @brief decrypts the data, throws if the document it belongs to was closed
+         */
+        auto decrypt( ) -> data_t;
+
+        in_data_t data;
+        // keeps data alive
+        std::shared_ptr<const void> owner;
+        std::size_t size;
+        std::weak_ptr<PDFBaseSecurityHandler> handler;
+        std::shared_ptr<PDFRef> ref;
+        std::once_flag decrypted;
+        // set once the decrypted data was assigned
+        std::atomic_bool done = false;
+    };
+
     class PDFString : public PDFBaseObject
     {
     public:
@@ -224,6 +265,41 @@ namespace vrock::pdf
         virtual auto get_string( ) -> std::string;
         virtual auto get_data( ) -> data_t;
         virtual auto set( in_data_t data ) -> void;
+
+        /**
+         * @brief sets encrypted data, which is only decrypted by handler when the string is read
+         */
+        auto set_encrypted( data_t data, const std::shared_ptr<PDFBaseSecurityHandler> &handler,
+                            std::shared_ptr<PDFRef> ref ) -> void;
+
+        /**
+         * @brief size of the data without decrypting it, strings which are still encrypted report the size of the encrypted data
+         */
+        auto get_size( ) -> std::size_t;
+
+    protected:
+        /**
+         * @brief passes the decrypted data to assign_decrypted on the first call after set_encrypted
+         */
+        auto decrypt( ) -> void
+        {
+            if ( encrypted )
+                decrypt_once( );
+        }
+
+        virtual auto assign_decrypted( data_t data ) -> void
+        {
+        }
+
+        virtual auto value_size( ) const -> std::size_t
+        {
+            return 0;
+        }
+
+        std::unique_ptr<PDFEncryptedData> encrypted;
+
+    private:
+        auto decrypt_once( ) -> void;
     };
 
     class PDFByteString : public PDFString
@@ -236,6 +312,10 @@ namespace vrock::pdf
         auto get_data( ) -> data_t override;
         auto set( in_data_t data ) -> void override;
 
+    protected:
+        auto assign_decrypted( data_t d ) -> void override;
+        auto value_size( ) const -> std::size_t override;
+
     private:
         data_t data;
     };
@@ -254,6 +334,9 @@ namespace vrock::pdf
         virtual auto convert_from( const std::string &str ) -> std::string = 0;
 
     protected:
+        auto assign_decrypted( data_t d ) -> void override;
+        auto value_size( ) const -> std::size_t override;
+
         std::string str;
     };
 
@@ -275,11 +358,14 @@ namespace vrock::pdf
                                     d = { } );
         ~PDFDictionary( ) override = default;
 
-        auto get( const std::string &k, bool resolve = true ) -> std::shared_ptr<PDFBaseObject>;
+        /**
+         * @brief looks up k without allocating, well-known names like names::Type are compared by id
+         */
+        auto get( PDFNameKey k, bool resolve = true ) -> std::shared_ptr<PDFBaseObject>;
 
         template <typename T>
             requires std::is_base_of_v<PDFBaseObject, T>
-        auto get( const std::string &k, bool resolve = true ) -> std::shared_ptr<T>
+        auto get( PDFNameKey k, bool resolve = true ) -> std::shared_ptr<T>
         {
             if ( auto obj = get( k, resolve ) )
                 return obj->to<T>( );
@@ -288,9 +374,9 @@ namespace vrock::pdf
 
         auto set( const std::string &k, std::shared_ptr<PDFBaseObject> obj ) -> void;
 
-        auto inline has( const std::string &k ) const -> bool
+        auto inline has( PDFNameKey k ) const -> bool
         {
-            return dict.contains( std::make_shared<PDFName>( k ) );
+            return dict.contains( k );
         }
 
         std::unordered_map<std::shared_ptr<PDFName>, std::shared_ptr<PDFBaseObject>, PDFNamePtrHash, PDFNamePtrEqual>
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vrock/utils/List.hpp>
+#include <vrock/utils/ThreadPool.hpp>
 
 #include "RenderableObject.hpp"
 
@@ -25,11 +26,11 @@ namespace vrock::pdf
         std::shared_ptr<PDFDictionary> dictionary;
         PageTreeNode *parent;
 
-        auto get_property( const std::string &name ) -> std::shared_ptr<PDFBaseObject>;
+        auto get_property( PDFNameKey name ) -> std::shared_ptr<PDFBaseObject>;
 
         template <typename T>
             requires std::is_base_of_v<PDFBaseObject, T>
-        auto get_property( const std::string &name ) -> std::shared_ptr<T>
+        auto get_property( PDFNameKey name ) -> std::shared_ptr<T>
         {
             return get_property( name )->to<T>( );
         }
@@ -56,6 +57,16 @@ namespace vrock::pdf
 
         auto get_page( std::size_t idx ) -> std::shared_ptr<Page>;
 
+        /**
+         * @brief loads the kid at idx if it is a page. loading different kids is safe to do concurrently
+         */
+        auto load_page( std::size_t idx ) -> std::shared_ptr<Page>;
+
+        /**
+         * @brief appends all kids that are not page tree nodes in page order
+         */
+        auto collect_leaves( std::vector<std::pair<PageTreeNode *, std::size_t>> &leaves ) -> void;
+
         std::vector<std::shared_ptr<PageBaseObject>> kids = { };
         std::int32_t count = 0;
     };
@@ -70,6 +81,17 @@ namespace vrock::pdf
         auto get_pages( ) -> utils::List<std::shared_ptr<Page>>;
         auto get_page_count( ) -> std::int32_t;
 
+        /**
+         * @brief loads all pages on the threads of the pool
+         */
+        auto get_pages_parallel( utils::ThreadPool &pool ) -> utils::List<std::shared_ptr<Page>>;
+
+        /**
+         * @brief loads all pages and parses their content streams on the threads of the pool
+         * @return text of each page in page order
+         */
+        auto extract_text_parallel( utils::ThreadPool &pool ) -> std::vector<utils::List<std::shared_ptr<Text>>>;
+
     private:
         utils::List<std::shared_ptr<Page>> pages;
         std::shared_ptr<PageTreeNode> page_tree;
@@ -6,6 +6,8 @@
 
 #include "PDFContext.hpp"
 
+#include <mutex>
+
 namespace vrock::pdf
 {
     class PDFObjectParser;
@@ -24,10 +26,25 @@ namespace vrock::pdf
         return PDFStreamType::None;
     }
 
+    /**
+     * @brief a stream keeps its encoded bytes, usually as a view into the input source, and runs its filters when
+     * the decoded content is requested the first time
+     */
     class PDFStream : public PDFBaseObject
     {
     public:
-        PDFStream( std::shared_ptr<PDFDictionary> dictionary, in_data_t _data, PDFStreamType t = PDFStreamType::Raw );
+        /**
+         * @brief owner keeps _data alive, without owner the data is copied
+         */
+        PDFStream( std::shared_ptr<PDFDictionary> dictionary, in_data_t _data, PDFStreamType t = PDFStreamType::Raw,
+                   std::shared_ptr<const void> owner = nullptr );
+        /**
+         * @brief stream with encrypted data, which is decrypted by handler when it is accessed the first time. owner
+         * keeps the encrypted data alive until then.
+         */
+        PDFStream( std::shared_ptr<PDFDictionary> dictionary, in_data_t encrypted_data,
+                   std::shared_ptr<const void> owner, const std::shared_ptr<PDFBaseSecurityHandler> &handler,
+                   std::shared_ptr<PDFRef> ref );
 
         template <typename T>
             requires std::is_base_of_v<PDFStream, T>
@@ -40,35 +57,95 @@ namespace vrock::pdf
             return nullptr;
         }
 
+        /**
+         * @brief true if every filter of the stream is reversed losslessly, so decoded holds the decoded content
+         */
+        auto is_decoded( ) const -> bool;
+
+        /**
+         * @brief true if the last filter is an image compression like DCTDecode. decoded then holds the compressed
+         * image, e.g. the JPEG file, which is decoded by PDFImage
+         */
+        auto is_image( ) const -> bool;
+
+        /**
+         * @brief encoded bytes of the stream as they are stored in the file, after decryption
+         */
+        auto raw( ) -> in_data_t;
+
+        /**
+         * @brief decoded content of the stream. the filters run on the first call and the result is cached until
+         * release is called
+         */
+        auto decoded( ) -> const data_t &;
+
+        /**
+         * @brief decodes the content without caching it, for streams that are only read once
+         */
+        auto decode( ) -> data_t;
+
+        /**
+         * @brief frees the cached decoded content, references returned by decoded become invalid
+         */
+        auto release( ) -> void;
+
+        /**
+         * @brief size of the decoded content if it is cached and of the encoded bytes otherwise
+         */
+        auto get_size( ) const -> std::size_t;
+
+        /**
+         * @brief bytes owned by the stream, the cached decoded content and encoded data that does not view the input
+         */
+        virtual auto memory_size( ) const -> std::size_t;
+
         PDFStreamType stream_type;
         std::shared_ptr<PDFDictionary> dict;
-        data_t data;
 
         utils::List<std::string> filters = { };
+
+    private:
+        auto read_filters( ) -> void;
+        auto run_filters( ) -> data_t;
+
+        in_data_t encoded;
+        // keeps encoded alive, either the input source or storage
+        std::shared_ptr<const void> owner;
+        data_t storage;
+        std::unique_ptr<PDFEncryptedData> encrypted;
+
+        mutable std::mutex mutex;
+        data_t data;
+        bool cached = false;
     };
 
     class PDFObjectStream : public PDFStream
     {
     public:
-        explicit PDFObjectStream( std::shared_ptr<PDFDictionary> d, in_data_t data, std::shared_ptr<PDFContext> ctx );
+        explicit PDFObjectStream( std::shared_ptr<PDFDictionary> d, in_data_t data, std::shared_ptr<PDFContext> ctx,
+                                  std::shared_ptr<const void> owner = nullptr );
 
         auto get_object( std::size_t idx ) -> std::shared_ptr<PDFBaseObject>;
 
+        auto memory_size( ) const -> std::size_t override;
+
     private:
-        std::unordered_map<std::shared_ptr<PDFRef>, std::shared_ptr<PDFBaseObject>> objects = { };
         std::vector<std::pair<std::uint32_t, std::size_t>> offsets = { };
         std::shared_ptr<PDFObjectParser> parser;
+        std::mutex parser_mutex;
         std::shared_ptr<PDFContext> context;
         std::size_t first = 0;
+        // size of the decoded data owned by the parser
+        std::size_t content_size = 0;
     };
 
     class PDFXRefStream : public PDFStream
     {
     public:
-        explicit PDFXRefStream( std::shared_ptr<PDFDictionary> d, in_data_t data );
+        explicit PDFXRefStream( std::shared_ptr<PDFDictionary> d, in_data_t data,
+                                std::shared_ptr<const void> owner = nullptr );
 
-        auto get_entries( ) -> std::unordered_map<std::shared_ptr<XRefEntry>, std::shared_ptr<XRefEntry>,
-                                                  XRefEntryPtrHash, XRefEntryPtrEqual>;
+        auto get_entries( ) -> std::vector<XRefEntry>;
     };
 
     template <>
@@ -96,6 +96,7 @@ namespace vrock::pdf
     };
 
     class Form;
+    class ContentProgram;
 
     class ResourceDictionary
     {
@@ -131,6 +132,17 @@ namespace vrock::pdf
 
         auto get_text( ) -> utils::List<std::shared_ptr<Text>>;
 
+        /**
+         * @brief interprets the content streams only until max_characters of text were found. the result is not
+         * cached.
+         */
+        auto get_text( std::size_t max_characters ) -> utils::List<std::shared_ptr<Text>>;
+
+        /**
+         * @brief the compiled content streams, compiled on first use
+         */
+        auto get_program( ) -> std::shared_ptr<ContentProgram>;
+
         std::shared_ptr<ResourceDictionary> resources = nullptr;
 
     protected:
@@ -138,6 +150,7 @@ namespace vrock::pdf
         utils::List<std::shared_ptr<Image>> images = { };
         utils::List<std::shared_ptr<Text>> text = { };
         std::vector<std::shared_ptr<PDFStream>> content_streams = { };
+        std::shared_ptr<ContentProgram> program = nullptr;
 
         std::shared_ptr<PDFContext> context;
 
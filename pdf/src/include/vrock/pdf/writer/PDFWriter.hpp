@@ -0,0 +1,147 @@
+#pragma once
+
+#include "vrock/pdf/structure/PDFContext.hpp"
+#include "vrock/pdf/structure/PDFFilters.hpp"
+#include "vrock/pdf/structure/PDFStreams.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace vrock::pdf
+{
+    struct PDFWriteOptions
+    {
+        /**
+         * @brief zlib compression level from 0 to 9 for streams, -1 selects zlib's default level
+         */
+        int compression_level = -1;
+        /**
+         * @brief pack objects that are not streams into compressed object streams
+         */
+        bool object_streams = true;
+        /**
+         * @brief maximum number of objects in one object stream
+         */
+        std::size_t objects_per_stream = 128;
+        /**
+         * @brief compresses large streams in parallel on this pool, without a pool they are compressed on the writing
+         * thread
+         */
+        std::shared_ptr<utils::ThreadPool> thread_pool = nullptr;
+    };
+
+    /**
+     * @brief serializes all objects reachable from the trailer of a context into a new document. objects are
+     * renumbered in the order they are reached, unreachable objects are dropped and the cross-reference table is
+     * written as a compressed XRef stream. the output is not encrypted.
+     *
+     * without a context the writer produces a document object by object: begin, add_object and add_stream as often
+     * as needed and finish. every object is written to the output stream once it is complete, only the offsets of the
+     * objects and the current object stream are kept in memory. write throws for such a writer.
+     */
+    class PDFWriter
+    {
+    public:
+        explicit PDFWriter( std::shared_ptr<PDFContext> ctx, PDFWriteOptions options = { } );
+        explicit PDFWriter( std::ostream &sink, PDFWriteOptions options = { } );
+
+        auto write( ) -> data_t;
+        /**
+         * @brief writes the document to sink while it is serialized instead of collecting it in memory
+         */
+        auto write( std::ostream &sink ) -> void;
+
+        /**
+         * @brief serializes the objects returned by PDFContext::get_modified_objects as an incremental update, which
+         * keeps the original object numbers and links the previous cross-reference section with /Prev
+         * @param offset size of the file the update is appended to
+         */
+        auto append( std::size_t offset ) -> data_t;
+
+        /**
+         * @brief offset of the cross-reference section written last
+         */
+        auto get_startxref( ) const -> std::size_t
+        {
+            return startxref;
+        }
+
+        /**
+         * @brief appends the serialized form of a direct object, references are written with their new numbers
+         */
+        auto write_value( const std::shared_ptr<PDFBaseObject> &obj, data_t &o ) -> void;
+
+        /**
+         * @brief writes the header of a new document
+         */
+        auto begin( ) -> void;
+
+        /**
+         * @brief reserves an object number, so objects can reference objects that are added later
+         */
+        auto reserve( ) -> std::shared_ptr<PDFRef>;
+
+        /**
+         * @brief writes obj as the indirect object ref or as a new object if ref is nullptr. references inside obj
+         * are written as they are.
+         */
+        auto add_object( const std::shared_ptr<PDFBaseObject> &obj, std::shared_ptr<PDFRef> ref = nullptr )
+            -> std::shared_ptr<PDFRef>;
+
+        /**
+         * @brief writes a stream with the content passed to the consumer by producer. the content is compressed
+         * while it is produced unless dict already has a Filter, the Length is written as separate object. throws if
+         * the written content does not fit a PDF integer.
+         */
+        auto add_stream( const std::shared_ptr<PDFDictionary> &dict,
+                         const std::function<void( const consumer_t & )> &producer,
+                         std::shared_ptr<PDFRef> ref = nullptr ) -> std::shared_ptr<PDFRef>;
+
+        /**
+         * @brief writes the cross-reference section with the entries of trailer, which has to contain Root
+         */
+        auto finish( const std::shared_ptr<PDFDictionary> &trailer ) -> void;
+
+    private:
+        auto write_document( ) -> void;
+        auto flush( ) -> void;
+        auto compress( in_data_t data ) const -> data_t;
+        auto number_of( const std::shared_ptr<PDFRef> &ref ) -> std::uint32_t;
+        auto write_object( std::uint32_t number, const std::shared_ptr<PDFBaseObject> &obj ) -> void;
+        auto write_stream( std::uint32_t number, const std::shared_ptr<PDFStream> &stream,
+                           std::uint32_t generation = 0 ) -> void;
+        auto flush_object_stream( ) -> void;
+        auto write_xref( const data_t &trailer, std::size_t size ) -> void;
+        auto write_xref_table( const data_t &trailer, std::size_t size ) -> void;
+        auto begin_object( std::uint32_t number, std::uint32_t generation = 0 ) -> void;
+        auto set_entry( std::uint32_t number, XRefEntry entry ) -> void;
+
+        std::shared_ptr<PDFContext> context;
+        PDFWriteOptions options;
+        data_t out;
+        // out is moved to the sink after every object if there is one
+        std::ostream *sink = nullptr;
+        // offset of out in the file, non zero for incremental updates and once out was flushed to the sink
+        std::size_t base_offset = 0;
+        // full writes renumber objects, incremental updates keep the numbers of the document
+        bool renumber = true;
+        std::size_t startxref = 0;
+
+        // (object number << 32 | generation number) of the source document to the new object number
+        std::unordered_map<std::uint64_t, std::uint32_t> numbers;
+        std::deque<std::pair<std::shared_ptr<PDFRef>, std::uint32_t>> pending;
+        std::uint32_t next_number = 1;
+        // indexed by the new object number
+        std::vector<XRefEntry> entries;
+
+        // object stream currently being filled
+        data_t stream_offsets;
+        data_t stream_objects;
+        std::vector<std::uint32_t> stream_numbers;
+    };
+} // namespace vrock::pdf
\ No newline at end of file
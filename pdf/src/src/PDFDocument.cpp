@@ -28,23 +28,32 @@ namespace vrock::pdf
         return { };
     }
 
-    PDFDocument::PDFDocument( std::filesystem::path path ) : file_path( std::move( path ) )
+    PDFDocument::PDFDocument( std::filesystem::path path, PDFOpenMode mode )
+        : PDFDocument( std::move( path ), mode, nullptr )
     {
-        std::ifstream file( file_path, std::ifstream::binary );
-        std::stringstream buffer;
-        buffer << file.rdbuf( );
-        file.close( );
+    }
 
-        context = std::make_shared<PDFContext>( std::make_shared<PDFObjectParser>( buffer.str( ) ) );
-        buffer.clear( );
+    PDFDocument::PDFDocument( std::filesystem::path path, utils::ThreadPool &pool, PDFOpenMode mode )
+        : PDFDocument( std::move( path ), mode, &pool )
+    {
+    }
+
+    PDFDocument::PDFDocument( std::filesystem::path path, PDFOpenMode mode, utils::ThreadPool *pool )
+        : file_path( std::move( path ) )
+    {
+        auto source = mode == PDFOpenMode::MemoryMapped ? map_file( file_path ) : read_file( file_path );
+        context = std::make_shared<PDFContext>( std::make_shared<PDFObjectParser>( std::move( source ) ) );
         context->parser->set_context( context );
-        context->init( );
+        if ( pool )
+            context->init( *pool );
+        else
+            context->init( );
 
         std::function<void( )> fn = [ this ]( ) {
-            if ( auto root = context->trailer->get<PDFDictionary>( "Root" ) )
+            if ( auto root = context->trailer->get<PDFDictionary>( names::Root ) )
             {
                  // load pages from Root dictionary
-                 if ( auto pages_root = root->get<PDFDictionary>( "Pages" ) )
+                 if ( auto pages_root = root->get<PDFDictionary>( names::Pages ) )
                      page_tree = PDFPageTree( pages_root, context );
                  else throw std::runtime_error( "Pages is not a Dictionary" );
             }
@@ -52,7 +61,7 @@ namespace vrock::pdf
                 throw std::runtime_error( "missing required Root entry in Trailer Dictionary" );
         };
 
-        if ( auto encrypt = context->trailer->get<PDFDictionary>( "Encrypt" ) )
+        if ( auto encrypt = context->trailer->get<PDFDictionary>( names::Encrypt ) )
         {
             auto std_sec = std::make_shared<PDFStandardSecurityHandler>( encrypt, context, fn );
             decryption_handler = std_sec;
@@ -71,9 +80,76 @@ namespace vrock::pdf
 
     auto PDFDocument::save( PDFSaveMode mode ) -> void
     {
+        save( file_path, mode );
     }
 
     auto PDFDocument::save( std::filesystem::path path, PDFSaveMode mode ) -> void
     {
+        if ( mode == PDFSaveMode::Append )
+            return append( path );
+        if ( !context )
+            throw std::runtime_error( "the document has no content to save" );
+
+        // objects may still be read lazily from the source file, so it is only replaced after writing is done
+        auto tmp = path;
+        tmp += ".tmp";
+        try
+        {
+            std::ofstream file( tmp, std::ofstream::binary | std::ofstream::trunc );
+            if ( !file )
+                throw std::runtime_error( "failed to open file " + tmp.string( ) );
+            PDFWriter( context, write_options ).write( file );
+            file.flush( );
+            if ( !file )
+                throw std::runtime_error( "failed to write file " + tmp.string( ) );
+        }
+        catch ( ... )
+        {
+            std::error_code ec;
+            std::filesystem::remove( tmp, ec );
+            throw;
+        }
+        auto replaces_source = !file_path.empty( ) && std::filesystem::exists( path ) &&
+                               std::filesystem::equivalent( path, file_path );
+        std::filesystem::rename( tmp, path );
+        // the rewritten file is renumbered, so the offsets and object numbers of the context no longer describe it
+        if ( replaces_source )
+            source_rewritten = true;
+    }
+
+    auto PDFDocument::append( const std::filesystem::path &path ) -> void
+    {
+        // an update section is appended to the revision the document was read from
+        if ( file_path.empty( ) || !context )
+            throw std::runtime_error( "only documents read from a file can be saved incrementally" );
+        if ( source_rewritten )
+            throw std::runtime_error( "the document was overwritten, it has to be opened again to append to it" );
+        // a different target starts as a copy of the source file
+        auto in_place = std::filesystem::exists( path ) && std::filesystem::equivalent( path, file_path );
+        if ( !in_place )
+            std::filesystem::copy_file( file_path, path, std::filesystem::copy_options::overwrite_existing );
+        auto offset = std::filesystem::file_size( path );
+        auto writer = PDFWriter( context, write_options );
+        auto data = writer.append( offset );
+
+        bool written;
+        {
+            std::ofstream file( path, std::ofstream::binary | std::ofstream::app );
+            if ( !file )
+                throw std::runtime_error( "failed to open file " + path.string( ) );
+            file.write( data.data( ), static_cast<std::streamsize>( data.size( ) ) );
+            file.close( );
+            written = !file.fail( );
+        }
+        if ( !written )
+        {
+            // a partially written update section is cut off, so the previous revision stays readable
+            std::error_code ec;
+            std::filesystem::resize_file( path, offset, ec );
+            throw std::runtime_error( "failed to write file " + path.string( ) );
+        }
+        // a copy gets its own revision, the next update of the source still has to contain every modification
+        if ( in_place )
+            context->clear_modified( writer.get_startxref( ) );
     }
 } // namespace vrock::pdf
\ No newline at end of file
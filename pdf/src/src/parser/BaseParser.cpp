@@ -1,75 +1,67 @@
 #include "vrock/pdf/parser/BaseParser.hpp"
 
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <format>
+
 namespace vrock::pdf
 {
-    BaseParser::BaseParser( std::string s, long o ) : _string( std::move( s ) ), _offset( o )
+    BaseParser::BaseParser( std::string s, long o )
+        : BaseParser( std::make_shared<StringInputSource>( std::move( s ) ), o )
+    {
+    }
+
+    BaseParser::BaseParser( std::shared_ptr<InputSource> source, long o )
+        : _source( std::move( source ) ), _string( _source->view( ) ), _offset( o )
     {
     }
-    
+
     auto BaseParser::parse_double( ) -> double
     {
-        std::stringstream ss{ };
-        while ( _offset < _string.length( ) )
-        {
-            if ( !is_digit_plus_minus_dot( _string[ _offset ] ) )
-                break;
-            ss.put( _string[ _offset ] );
+        auto begin = _offset;
+        while ( _offset < _string.length( ) && is_digit_plus_minus_dot( _string[ _offset ] ) )
             if ( _string[ _offset++ ] == '.' )
                 break;
-        }
-        while ( _offset < _string.length( ) )
-        {
-            if ( !is_digit( _string[ _offset ] ) )
-                break;
-            ss.put( _string[ _offset++ ] );
-        }
-        return strtod( ss.str( ).c_str( ), nullptr );
+        while ( _offset < _string.length( ) && is_digit( _string[ _offset ] ) )
+            _offset++;
+        // from_chars does not accept a leading plus
+        if ( begin < _offset && _string[ begin ] == '+' )
+            begin++;
+        // a sign or dot without digits is read as 0 like in most readers, content streams contain them now and then
+        if ( std::none_of( _string.begin( ) + begin, _string.begin( ) + _offset, is_digit ) )
+            return 0;
+        double value = 0;
+        auto [ ptr, ec ] = std::from_chars( _string.data( ) + begin, _string.data( ) + _offset, value );
+        if ( ec != std::errc( ) || ptr == _string.data( ) + begin )
+            throw PDFParserException( std::format( "invalid number: {}", _string.substr( begin, _offset - begin ) ) );
+        return value;
     }
 
     auto BaseParser::parse_int( ) -> int
     {
         skip_comments_and_whitespaces( );
-        std::stringstream ss{ };
-        while ( _offset < _string.length( ) )
-        {
-            if ( !is_digit_plus_minus( _string[ _offset ] ) )
-                break;
-            ss.put( _string[ _offset++ ] );
-        }
-        if ( ss.str( ).length( ) != 0 )
-            return std::stoi( ss.str( ) );
-        return 0;
-    }
-
-    auto BaseParser::is_whitespace( char c ) -> bool
-    {
-        return std::find( _whitespace.begin( ), _whitespace.end( ), c ) != _whitespace.end( );
-    }
-
-    auto BaseParser::is_delimiter( char c ) -> bool
-    {
-        return std::find( _delimiter.begin( ), _delimiter.end( ), c ) != _delimiter.end( );
-    }
-
-    auto BaseParser::skip_whitespace( ) -> void
-    {
-        while ( _offset < _string.length( ) && is_whitespace( _string[ _offset ] ) )
+        auto begin = _offset;
+        while ( _offset < _string.length( ) && is_digit_plus_minus( _string[ _offset ] ) )
             _offset++;
+        if ( begin < _offset && _string[ begin ] == '+' )
+            begin++;
+        if ( std::none_of( _string.begin( ) + begin, _string.begin( ) + _offset, is_digit ) )
+            return 0;
+        int value = 0;
+        auto [ ptr, ec ] = std::from_chars( _string.data( ) + begin, _string.data( ) + _offset, value );
+        if ( ec != std::errc( ) || ptr == _string.data( ) + begin )
+            throw PDFParserException( std::format( "invalid integer: {}", _string.substr( begin, _offset - begin ) ) );
+        return value;
     }
 
     auto BaseParser::skip_comment( ) -> bool
     {
-        if ( _string[ _offset ] != '%' )
+        if ( _offset >= _string.length( ) || _string[ _offset ] != '%' )
             return false;
         while ( _offset < _string.length( ) )
-        {
-            if ( std::find( _endOfLine.begin( ), _endOfLine.end( ), _string[ _offset ] ) != _endOfLine.end( ) )
-            {
-                _offset++;
+            if ( is_class( _string[ _offset++ ], CharClass::EndOfLine ) )
                 return true;
-            }
-            _offset++;
-        }
         return true;
     }
 
@@ -80,12 +72,48 @@ namespace vrock::pdf
             skip_whitespace( );
     }
 
-    auto BaseParser::is_keyword( std::string key ) -> bool
+    auto BaseParser::is_keyword( std::string_view key ) -> bool
     {
-        for ( size_t i = _offset; i < _offset + key.length( ); i++ )
-            if ( i >= _string.length( ) || _string[ i ] != key[ i - _offset ] )
-                return false;
+        if ( _offset > _string.length( ) || !_string.substr( _offset ).starts_with( key ) )
+            return false;
         _offset += key.length( );
         return true;
     }
+
+    auto BaseParser::find( std::string_view key, std::size_t from ) const -> std::size_t
+    {
+        if ( key.empty( ) || key.length( ) > _string.length( ) )
+            return std::string_view::npos;
+        auto data = _string.data( );
+        auto last = _string.length( ) - key.length( );
+        while ( from <= last )
+        {
+            auto c = static_cast<const char *>( std::memchr( data + from, key[ 0 ], last - from + 1 ) );
+            if ( c == nullptr )
+                break;
+            from = c - data;
+            if ( std::memcmp( c + 1, key.data( ) + 1, key.length( ) - 1 ) == 0 )
+                return from;
+            from++;
+        }
+        return std::string_view::npos;
+    }
+
+    auto BaseParser::rfind( std::string_view key ) const -> std::size_t
+    {
+        // the searched keywords are usually close to the end, so the window grows from the end of the input
+        constexpr std::size_t initial_window = 1024;
+        auto window = initial_window;
+        while ( true )
+        {
+            auto begin = _string.length( ) > window ? _string.length( ) - window : 0;
+            auto pos = _string.substr( begin ).rfind( key );
+            if ( pos != std::string_view::npos )
+                return begin + pos;
+            if ( begin == 0 )
+                return std::string_view::npos;
+            // overlap the windows so a key crossing the boundary is found
+            window = window * 2 + key.length( );
+        }
+    }
 } // namespace vrock::pdf
\ No newline at end of file
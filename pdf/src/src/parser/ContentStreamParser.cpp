@@ -21,8 +21,184 @@ namespace vrock::pdf
         return res;
     }
 
+    namespace
+    {
+        // operators have at most three characters, packed into an integer they can be decoded by a switch
+        constexpr auto op_key( std::string_view op ) -> std::uint32_t
+        {
+            std::uint32_t key = 0;
+            for ( auto c : op )
+                key = key << 8 | static_cast<unsigned char>( c );
+            return key;
+        }
+
+        // operands after the last operator have no effect
+        auto drop_trailing_operands( ContentProgram &program ) -> void
+        {
+            if ( program.instructions.empty( ) )
+                program.operands.clear( );
+            else
+                program.operands.resize( program.instructions.back( ).first + program.instructions.back( ).count );
+        }
+    } // namespace
+
+    auto decode_operator( std::string_view op ) -> ContentStreamOperator
+    {
+        if ( op.empty( ) || op.length( ) > 3 )
+            return ContentStreamOperator::Unknown;
+        switch ( op_key( op ) )
+        {
+        case op_key( "b" ):
+            return ContentStreamOperator::b;
+        case op_key( "B" ):
+            return ContentStreamOperator::B;
+        case op_key( "b*" ):
+            return ContentStreamOperator::bs;
+        case op_key( "B*" ):
+            return ContentStreamOperator::Bs;
+        case op_key( "BDC" ):
+            return ContentStreamOperator::BDC;
+        case op_key( "BI" ):
+            return ContentStreamOperator::BI;
+        case op_key( "BMC" ):
+            return ContentStreamOperator::BMC;
+        case op_key( "BT" ):
+            return ContentStreamOperator::BT;
+        case op_key( "BX" ):
+            return ContentStreamOperator::BX;
+        case op_key( "c" ):
+            return ContentStreamOperator::c;
+        case op_key( "cm" ):
+            return ContentStreamOperator::cm;
+        case op_key( "CS" ):
+            return ContentStreamOperator::CS;
+        case op_key( "cs" ):
+            return ContentStreamOperator::cs;
+        case op_key( "d" ):
+            return ContentStreamOperator::d;
+        case op_key( "d0" ):
+            return ContentStreamOperator::d0;
+        case op_key( "d1" ):
+            return ContentStreamOperator::d1;
+        case op_key( "Do" ):
+            return ContentStreamOperator::Do;
+        case op_key( "DP" ):
+            return ContentStreamOperator::DP;
+        case op_key( "EI" ):
+            return ContentStreamOperator::EI;
+        case op_key( "EMC" ):
+            return ContentStreamOperator::EMC;
+        case op_key( "ET" ):
+            return ContentStreamOperator::ET;
+        case op_key( "EX" ):
+            return ContentStreamOperator::EX;
+        case op_key( "f" ):
+            return ContentStreamOperator::f;
+        case op_key( "F" ):
+            return ContentStreamOperator::F;
+        case op_key( "f*" ):
+            return ContentStreamOperator::fs;
+        case op_key( "G" ):
+            return ContentStreamOperator::G;
+        case op_key( "g" ):
+            return ContentStreamOperator::g;
+        case op_key( "gs" ):
+            return ContentStreamOperator::gs;
+        case op_key( "h" ):
+            return ContentStreamOperator::h;
+        case op_key( "i" ):
+            return ContentStreamOperator::i;
+        case op_key( "ID" ):
+            return ContentStreamOperator::ID;
+        case op_key( "j" ):
+            return ContentStreamOperator::j;
+        case op_key( "J" ):
+            return ContentStreamOperator::J;
+        case op_key( "k" ):
+            return ContentStreamOperator::k;
+        case op_key( "l" ):
+            return ContentStreamOperator::l;
+        case op_key( "m" ):
+            return ContentStreamOperator::m;
+        case op_key( "M" ):
+            return ContentStreamOperator::M;
+        case op_key( "MP" ):
+            return ContentStreamOperator::MP;
+        case op_key( "n" ):
+            return ContentStreamOperator::n;
+        case op_key( "q" ):
+            return ContentStreamOperator::q;
+        case op_key( "Q" ):
+            return ContentStreamOperator::Q;
+        case op_key( "re" ):
+            return ContentStreamOperator::re;
+        case op_key( "RG" ):
+            return ContentStreamOperator::RG;
+        case op_key( "rg" ):
+            return ContentStreamOperator::rg;
+        case op_key( "ri" ):
+            return ContentStreamOperator::ri;
+        case op_key( "s" ):
+            return ContentStreamOperator::s;
+        case op_key( "S" ):
+            return ContentStreamOperator::S;
+        case op_key( "SC" ):
+            return ContentStreamOperator::SC;
+        case op_key( "sc" ):
+            return ContentStreamOperator::sc;
+        case op_key( "SCN" ):
+            return ContentStreamOperator::SCN;
+        case op_key( "scn" ):
+            return ContentStreamOperator::scn;
+        case op_key( "sh" ):
+            return ContentStreamOperator::sh;
+        case op_key( "T*" ):
+            return ContentStreamOperator::Tst;
+        case op_key( "Tc" ):
+            return ContentStreamOperator::Tc;
+        case op_key( "Td" ):
+            return ContentStreamOperator::Td;
+        case op_key( "TD" ):
+            return ContentStreamOperator::TD;
+        case op_key( "Tf" ):
+            return ContentStreamOperator::Tf;
+        case op_key( "Tj" ):
+            return ContentStreamOperator::Tj;
+        case op_key( "TJ" ):
+            return ContentStreamOperator::TJ;
+        case op_key( "TL" ):
+            return ContentStreamOperator::TL;
+        case op_key( "Tm" ):
+            return ContentStreamOperator::Tm;
+        case op_key( "Tr" ):
+            return ContentStreamOperator::Tr;
+        case op_key( "Ts" ):
+            return ContentStreamOperator::Ts;
+        case op_key( "Tw" ):
+            return ContentStreamOperator::Tw;
+        case op_key( "Tz" ):
+            return ContentStreamOperator::Tz;
+        case op_key( "v" ):
+            return ContentStreamOperator::v;
+        case op_key( "w" ):
+            return ContentStreamOperator::w;
+        case op_key( "W" ):
+            return ContentStreamOperator::W;
+        case op_key( "W*" ):
+            return ContentStreamOperator::Ws;
+        case op_key( "y" ):
+            return ContentStreamOperator::y;
+        case op_key( "'" ):
+            return ContentStreamOperator::NextLine;
+        case op_key( "\"" ):
+            return ContentStreamOperator::SpacingNextLineShowText;
+        default:
+            return ContentStreamOperator::Unknown;
+        }
+    }
+
     PDFOperator::PDFOperator( std::string op )
-        : PDFBaseObject( PDFObjectType::Operator ), _operator( op ), o( string_to_operator[ op ] )
+        : PDFBaseObject( PDFObjectType::Operator ), _operator( std::move( op ) ), o( decode_operator( _operator ) )
     {
     }
 
@@ -37,43 +213,86 @@ namespace vrock::pdf
         : PDFObjectParser( std::move( data ) ), res( std::move( res_dict ) )
     {
         set_context( std::move( ctx ) );
+        // operands only live as long as the compiled program
+        set_arena( std::make_shared<PDFObjectArena>( 64 * 1024 ) );
 
         graphic_state_stack.push( GraphicState( ) );
-        auto operator_seq = to_operator_array( );
+        execute( *compile( ) );
+    }
+
+    ContentStreamParser::ContentStreamParser( std::string data, std::shared_ptr<PDFContext> ctx )
+        : ContentStreamParser( std::make_shared<StringInputSource>( std::move( data ) ), std::move( ctx ) )
+    {
+    }
+
+    ContentStreamParser::ContentStreamParser( std::shared_ptr<InputSource> source, std::shared_ptr<PDFContext> ctx )
+        : PDFObjectParser( std::move( source ) )
+    {
+        set_context( std::move( ctx ) );
+        set_arena( std::make_shared<PDFObjectArena>( 64 * 1024 ) );
+    }
+
+    ContentStreamParser::ContentStreamParser( std::shared_ptr<ResourceDictionary> res_dict,
+                                              std::shared_ptr<PDFContext> ctx )
+        : res( std::move( res_dict ) )
+    {
+        set_context( std::move( ctx ) );
+        graphic_state_stack.push( GraphicState( ) );
+    }
+
+    ContentStreamParser::ContentStreamParser( std::shared_ptr<const ContentProgram> program,
+                                              std::shared_ptr<ResourceDictionary> res_dict,
+                                              std::shared_ptr<PDFContext> ctx )
+        : res( std::move( res_dict ) )
+    {
+        set_context( std::move( ctx ) );
+        graphic_state_stack.push( GraphicState( ) );
+        execute( *program );
+    }
 
+    auto ContentStreamParser::execute( const ContentProgram &program ) -> void
+    {
+        for ( const auto &instruction : program.instructions )
+            if ( !execute( ContentOperands( program, instruction ) ) )
+                return;
+    }
+
+    auto ContentStreamParser::execute( const ContentOperands &op ) -> bool
+    {
         try
         {
-            std::size_t i = 0;
-            for ( auto op : operator_seq )
-            {
-                if ( operator_fn.find( op->o ) != operator_fn.end( ) )
-                {
-                    operator_fn[ op->o ]( this, op );
-                }
-            }
-            // else // if ( op->o == objects::ContentStreamOperator::Tr )
-            //     for ( auto o : op->paramteres )
-            //         log::get_logger( "pdf" )->log->debug( "{}: {}", op->_operator, o->to_string( ) );
+            if ( auto fn = operator_table[ static_cast<std::size_t>( op.op( ) ) ] )
+                fn( this, op );
+            return true;
         }
         catch ( const std::exception &e )
         {
             std::cout << e.what( ) << std::endl;
             // log::get_logger( "pdf" )->log->debug( "ContentStreamParser Exception: {}", e.what( ) );
+            return false;
         }
     }
 
+    auto ContentStreamParser::interpret( const std::vector<std::shared_ptr<PDFStream>> &streams,
+                                         const std::function<bool( )> &stop ) -> void
+    {
+        for ( const auto &op : stream_content( streams, context ) )
+            if ( !execute( op ) || ( stop && stop( ) ) )
+                return;
+    }
+
     auto ContentStreamParser::parse_object( std::shared_ptr<PDFRef> ref, bool decrypt )
         -> std::shared_ptr<PDFBaseObject>
     {
         skip_whitespace( );
         if ( is_keyword( "true" ) )
-            return std::make_shared<PDFBool>( true );
+            return make_object<PDFBool>( arena, true );
         if ( is_keyword( "false" ) )
-            return std::make_shared<PDFBool>( false );
+            return make_object<PDFBool>( arena, false );
         if ( is_keyword( "null" ) )
-            return std::make_shared<PDFNull>( );
+            return make_object<PDFNull>( arena );
 
-        if ( _string[ _offset ] == '<' && _string[ _offset + 1 ] == '<' )
+        if ( _string[ _offset ] == '<' && _offset + 1 < _string.length( ) && _string[ _offset + 1 ] == '<' )
             return parse_dictionary( ref, decrypt );
         if ( _string[ _offset ] == '/' )
             return parse_name( );
@@ -91,80 +310,158 @@ namespace vrock::pdf
     }
 
     auto ContentStreamParser::parse_operator( ) -> std::shared_ptr<PDFOperator>
+    {
+        return make_object<PDFOperator>( arena, std::string( lex_operator( ) ) );
+    }
+
+    auto ContentStreamParser::lex_operator( ) -> std::string_view
     {
         if ( _string[ _offset ] == '\'' || _string[ _offset ] == '"' )
-            return std::make_shared<PDFOperator>( _string.substr( _offset++, 1 ) );
-        char i = 0;
-        while ( _string.length( ) > _offset &&
+            return _string.substr( _offset++, 1 );
+        std::size_t i = 0;
+        while ( _string.length( ) > _offset + i &&
                 ( ( _string[ _offset + i ] >= 'A' && _string[ _offset + i ] <= 'Z' ) ||
                   ( _string[ _offset + i ] >= 'a' && _string[ _offset + i ] <= 'z' ) || _string[ _offset + i ] == '*' ||
                   _string[ _offset + i ] == '0' || _string[ _offset + i ] == '1' ) )
             i++;
-        auto str = _string.substr( _offset, i );
+        // characters like ']' or '_' are within 'A' to 'z' but no operator, they would never be consumed
+        if ( i == 0 )
+            throw PDFParserException(
+                std::format( "Unknown operator: {}", _string.substr( _offset > 20 ? _offset - 20 : 0, 50 ) ) );
+        auto op = _string.substr( _offset, i );
         _offset += i;
-        return std::make_shared<PDFOperator>( str );
+        return op;
+    }
+
+    auto ContentStreamParser::compile( ) -> std::shared_ptr<ContentProgram>
+    {
+        auto program = std::make_shared<ContentProgram>( );
+        while ( next_instruction( *program ) )
+            ;
+        drop_trailing_operands( *program );
+        return program;
     }
 
-    auto ContentStreamParser::to_operator_array( ) -> std::vector<std::shared_ptr<PDFOperator>>
+    auto ContentStreamParser::next_instruction( ContentProgram &program ) -> bool
     {
-        std::vector<std::shared_ptr<PDFOperator>> operators;
-        std::vector<std::shared_ptr<PDFBaseObject>> params = { };
-        while ( _string.length( ) > _offset )
+        std::uint32_t first = 0;
+        if ( !program.instructions.empty( ) )
+            first = program.instructions.back( ).first + program.instructions.back( ).count;
+        auto add_operand = [ &program ]( ContentOperand::Kind kind, std::size_t index ) {
+            program.operands.push_back( { kind, static_cast<std::uint32_t>( index ) } );
+        };
+        auto add_object = [ & ]( std::shared_ptr<PDFBaseObject> obj ) {
+            add_operand( ContentOperand::Kind::Object, program.objects.size( ) );
+            program.objects.push_back( std::move( obj ) );
+        };
+
+        while ( true )
         {
-            auto obj = parse_object( );
-            if ( obj->type == PDFObjectType::Operator )
+            skip_comments_and_whitespaces( );
+            if ( _offset >= _string.length( ) )
+                return false;
+            auto c = _string[ _offset ];
+            if ( is_digit_plus_minus_dot( c ) )
+            {
+                add_operand( ContentOperand::Kind::Number, program.numbers.size( ) );
+                program.numbers.push_back( parse_double( ) );
+            }
+            else if ( c == '/' )
+            {
+                add_operand( ContentOperand::Kind::Name, program.names.size( ) );
+                program.names.push_back( std::move( parse_name( )->name ) );
+            }
+            else if ( c == '<' && _offset + 1 < _string.length( ) && _string[ _offset + 1 ] == '<' )
+                add_object( parse_dictionary( nullptr, false ) );
+            else if ( c == '<' )
+                add_object( parse_hex_string( nullptr, false ) );
+            else if ( c == '(' )
+                add_object( parse_string( nullptr, false ) );
+            else if ( c == '[' )
+                add_object( parse_array( nullptr, false ) );
+            else if ( ( c >= 'A' && c <= 'z' ) || c == '\'' || c == '"' )
             {
-                auto op = obj->to<PDFOperator>( );
-                op->paramteres = std::move( params );
-                params = { };
-                operators.emplace_back( op );
+                auto op = lex_operator( );
+                if ( op == "true" || op == "false" )
+                    add_object( make_object<PDFBool>( arena, op == "true" ) );
+                else if ( op == "null" )
+                    add_object( make_object<PDFNull>( arena ) );
+                else
+                {
+                    auto count = static_cast<std::uint32_t>( program.operands.size( ) ) - first;
+                    program.instructions.push_back( { decode_operator( op ), first, count } );
+                    return true;
+                }
             }
             else
-                params.push_back( obj );
-            skip_whitespace( );
+                throw PDFParserException(
+                    std::format( "Unknown object: {}", _string.substr( _offset > 20 ? _offset - 20 : 0, 50 ) ) );
         }
-        return operators;
     }
 
-    void check_operator_param_count( const std::shared_ptr<PDFOperator> &_operator, std::size_t count )
+    namespace
     {
-        if ( _operator->paramteres.size( ) != count )
-            throw std::runtime_error( std::format( "{} operator parameter wrong", _operator->_operator ) );
-    }
+        // the decoded content is owned by the lexer, so it is freed once the stream was parsed instead of staying
+        // cached in the stream
+        auto decode_content( const std::shared_ptr<PDFStream> &stream ) -> std::shared_ptr<InputSource>
+        {
+            return std::make_shared<StringInputSource>( stream->decode( ) );
+        }
+    } // namespace
 
-    template <typename T, typename R>
-    R check_type_and_get_value( const std::shared_ptr<PDFOperator> &_operator, std::size_t idx,
-                                std::function<R( std::shared_ptr<T> )> fn, R _default = R( ) )
+    auto compile_content( std::string data, std::shared_ptr<PDFContext> ctx ) -> std::shared_ptr<ContentProgram>
     {
-        if ( auto obj = _operator->paramteres[ idx ]->to<T>( ) )
-            return fn( obj );
-        return _default;
+        return ContentStreamParser( std::move( data ), std::move( ctx ) ).compile( );
     }
 
-    double check_type_and_get_double( const std::shared_ptr<PDFOperator> &_operator, std::size_t idx )
+    auto compile_content( const std::vector<std::shared_ptr<PDFStream>> &streams, std::shared_ptr<PDFContext> ctx )
+        -> std::shared_ptr<ContentProgram>
     {
-        return check_type_and_get_value<PDFNumber, double>(
-            _operator, idx, []( auto n ) { return n->as_double( ); }, 0.0 );
+        // operators may take operands from the previous stream, so all streams append to the same program
+        auto program = std::make_shared<ContentProgram>( );
+        for ( const auto &stream : streams )
+        {
+            auto lexer = ContentStreamParser( decode_content( stream ), ctx );
+            while ( lexer.next_instruction( *program ) )
+                ;
+        }
+        drop_trailing_operands( *program );
+        return program;
     }
 
-    std::int32_t check_type_and_get_int( const std::shared_ptr<PDFOperator> &_operator, std::size_t idx )
+    auto stream_content( std::vector<std::shared_ptr<PDFStream>> streams, std::shared_ptr<PDFContext> ctx )
+        -> utils::Generator<const ContentOperands &>
     {
-        return check_type_and_get_value<PDFNumber, std::int32_t>(
-            _operator, idx, []( auto n ) { return n->as_int( ); }, 0 );
+        // only the decoded stream and the operands of the operator being executed are held in memory
+        ContentProgram program;
+        for ( const auto &stream : streams )
+        {
+            auto lexer = ContentStreamParser( decode_content( stream ), ctx );
+            // an arena would keep every lexed object until the end of the stream, so operands are heap allocated
+            // and freed with the instruction
+            lexer.set_arena( nullptr );
+            while ( lexer.next_instruction( program ) )
+            {
+                const auto op = ContentOperands( program, program.instructions.back( ) );
+                co_yield op;
+                program.clear( );
+            }
+        }
     }
 
-    std::string check_type_and_get_name( const std::shared_ptr<PDFOperator> &_operator, std::size_t idx )
+    void check_operator_param_count( const ContentOperands &op, std::size_t count )
     {
-        return check_type_and_get_value<PDFName, std::string>(
-            _operator, idx, []( auto n ) { return n->name; }, "" );
+        if ( op.size( ) != count )
+            throw std::runtime_error(
+                std::format( "{} operator parameter wrong", operator_names[ static_cast<std::size_t>( op.op( ) ) ] ) );
     }
 
-    auto operator_cm( ContentStreamParser *parser, std::shared_ptr<PDFOperator> op ) -> void
+    auto operator_cm( ContentStreamParser *parser, const ContentOperands &op ) -> void
     {
         std::array<double, 6> data = { };
         check_operator_param_count( op, 6 );
         for ( size_t i = 0; i < 6; i++ )
-            data[ i ] = check_type_and_get_double( op, i );
+            data[ i ] = op.number( i );
 
         // TODO: check if this is correct behavior
         mat3 mat{ { { data[ 0 ], data[ 1 ], 0 }, { data[ 2 ], data[ 3 ], 0 }, { data[ 4 ], data[ 5 ], 1 } } };
@@ -172,7 +469,7 @@ namespace vrock::pdf
             mul( mat, parser->graphic_state_stack.top( ).current_transformation_matrix );
     }
 
-    void operator_Do( ContentStreamParser *parser, std::shared_ptr<PDFOperator> op )
+    void operator_Do( ContentStreamParser *parser, const ContentOperands &op )
     {
         auto &ctm = parser->graphic_state_stack.top( ).current_transformation_matrix;
         auto a = ctm[ 0 ][ 0 ];
@@ -187,7 +484,7 @@ namespace vrock::pdf
         auto q = ( a * d + b * e ) / ( a * e - b * d );
 
         check_operator_param_count( op, 1 );
-        auto name = check_type_and_get_name( op, 0 );
+        const auto &name = op.name( 0 );
 
         // check if image and if so add it to images
         if ( parser->res->images.contains( name ) )
@@ -204,68 +501,67 @@ namespace vrock::pdf
         }
     }
 
-    auto operator_gs( ContentStreamParser *parser, std::shared_ptr<PDFOperator> op ) -> void
+    auto operator_gs( ContentStreamParser *parser, const ContentOperands &op ) -> void
     {
         check_operator_param_count( op, 1 );
-        auto name = check_type_and_get_name( op, 0 );
+        const auto &name = op.name( 0 );
 
         if ( !parser->res->ext_g_state.contains( name ) )
             throw std::runtime_error( std::format( "gs '{}' not found!", name ) );
         parser->graphic_state_stack.top( ).apply_dict( parser->res->ext_g_state[ name ] );
     }
 
-    void operator_q( ContentStreamParser *parser, std::shared_ptr<PDFOperator> op )
+    void operator_q( ContentStreamParser *parser, const ContentOperands &op )
     {
         GraphicState tmp = parser->graphic_state_stack.top( );
         parser->graphic_state_stack.push( tmp );
     }
 
-    void operator_Q( ContentStreamParser *parser, std::shared_ptr<PDFOperator> op )
+    void operator_Q( ContentStreamParser *parser, const ContentOperands &op )
     {
         parser->graphic_state_stack.pop( );
     }
 
-    void operator_Tf( ContentStreamParser *parser, std::shared_ptr<PDFOperator> op )
+    void operator_Tf( ContentStreamParser *parser, const ContentOperands &op )
     {
         check_operator_param_count( op, 2 );
-        auto font = check_type_and_get_name( op, 0 );
+        const auto &font = op.name( 0 );
 
         if ( !parser->res->fonts.contains( font ) )
             throw std::runtime_error( std::format( "font '{}' not found!", font ) );
 
         parser->graphic_state_stack.top( ).text_state.font = parser->res->fonts[ font ];
-        parser->graphic_state_stack.top( ).text_state.font_size = check_type_and_get_int( op, 1 );
+        parser->graphic_state_stack.top( ).text_state.font_size = static_cast<std::int32_t>( op.number( 1 ) );
     }
 
-    void operator_Tc( ContentStreamParser *parser, std::shared_ptr<PDFOperator> op )
+    void operator_Tc( ContentStreamParser *parser, const ContentOperands &op )
     {
         check_operator_param_count( op, 1 );
-        parser->graphic_state_stack.top( ).text_state.character_spacing = check_type_and_get_double( op, 0 );
+        parser->graphic_state_stack.top( ).text_state.character_spacing = op.number( 0 );
     }
 
-    void operator_Tj( ContentStreamParser *parser, std::shared_ptr<PDFOperator> op )
+    void operator_Tj( ContentStreamParser *parser, const ContentOperands &op )
     {
         check_operator_param_count( op, 1 );
 
         auto text = std::make_shared<Text>( );
         parser->text.push_back( text );
-        text->text = check_type_and_get_value<PDFString, std::string>(
-            op, 0, []( auto s ) { return s->get_string( ); }, "" );
+        if ( auto str = op.object<PDFString>( 0 ) )
+            text->text = str->get_string( );
         text->offsets = { { text->text.length( ), 0 } };
         text->font_size = parser->graphic_state_stack.top( ).text_state.font_size;
         text->font = parser->graphic_state_stack.top( ).text_state.font;
     }
 
-    void operator_TJ( ContentStreamParser *parser, std::shared_ptr<PDFOperator> op )
+    void operator_TJ( ContentStreamParser *parser, const ContentOperands &op )
     {
         check_operator_param_count( op, 1 );
-        auto arr = check_type_and_get_value<PDFArray, std::vector<std::shared_ptr<PDFBaseObject>>>(
-            op, 0, []( auto a ) { return a->value; }, { } );
+        auto arr = op.object<PDFArray>( 0 );
 
         auto text = std::make_shared<Text>( );
         parser->text.push_back( text );
         int32_t offset = 0;
-        for ( const auto &i : arr )
+        for ( const auto &i : arr ? arr->value : std::vector<std::shared_ptr<PDFBaseObject>>{ } )
         {
             if ( auto str = i->to<PDFString>( ) )
             {
@@ -280,27 +576,27 @@ namespace vrock::pdf
         text->font = parser->graphic_state_stack.top( ).text_state.font;
     }
 
-    void operator_TL( ContentStreamParser *parser, std::shared_ptr<PDFOperator> op )
+    void operator_TL( ContentStreamParser *parser, const ContentOperands &op )
     {
         check_operator_param_count( op, 1 );
-        parser->graphic_state_stack.top( ).text_state.leading = check_type_and_get_int( op, 0 );
+        parser->graphic_state_stack.top( ).text_state.leading = static_cast<std::int32_t>( op.number( 0 ) );
     }
 
-    void operator_Tw( ContentStreamParser *parser, std::shared_ptr<PDFOperator> op )
+    void operator_Tw( ContentStreamParser *parser, const ContentOperands &op )
     {
         check_operator_param_count( op, 1 );
-        parser->graphic_state_stack.top( ).text_state.word_spacing = check_type_and_get_double( op, 0 );
+        parser->graphic_state_stack.top( ).text_state.word_spacing = op.number( 0 );
     }
 
-    void operator_Tz( ContentStreamParser *parser, std::shared_ptr<PDFOperator> op )
+    void operator_Tz( ContentStreamParser *parser, const ContentOperands &op )
     {
         check_operator_param_count( op, 1 );
-        parser->graphic_state_stack.top( ).text_state.horizontal_scaling = check_type_and_get_double( op, 0 );
+        parser->graphic_state_stack.top( ).text_state.horizontal_scaling = op.number( 0 );
     }
 
-    void operator_w( ContentStreamParser *parser, std::shared_ptr<PDFOperator> op )
+    void operator_w( ContentStreamParser *parser, const ContentOperands &op )
     {
         check_operator_param_count( op, 1 );
-        parser->graphic_state_stack.top( ).line_width = check_type_and_get_double( op, 0 );
+        parser->graphic_state_stack.top( ).line_width = op.number( 0 );
     }
 } // namespace vrock::pdf
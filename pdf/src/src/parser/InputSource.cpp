@@ -0,0 +1,164 @@
+#include "vrock/pdf/parser/InputSource.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vrock::pdf
+{
+    // amount of zeroed bytes required behind the end of the input
+    constexpr std::size_t mapping_slack = 8;
+
+    StringInputSource::StringInputSource( data_t d ) : data( std::move( d ) )
+    {
+    }
+
+    auto StringInputSource::view( ) const -> in_data_t
+    {
+        return data;
+    }
+
+    ViewInputSource::ViewInputSource( in_data_t d, std::shared_ptr<const void> o ) : data( d ), owner( std::move( o ) )
+    {
+    }
+
+    auto ViewInputSource::view( ) const -> in_data_t
+    {
+        return data;
+    }
+
+#if defined( _WIN32 )
+    MappedFileInputSource::MappedFileInputSource( const std::filesystem::path &path )
+    {
+        file = CreateFileW( path.c_str( ), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+        if ( file == INVALID_HANDLE_VALUE )
+        {
+            file = nullptr;
+            throw std::runtime_error( "failed to open file " + path.string( ) );
+        }
+        LARGE_INTEGER file_size;
+        if ( !GetFileSizeEx( file, &file_size ) )
+        {
+            CloseHandle( file );
+            throw std::runtime_error( "failed to get size of file " + path.string( ) );
+        }
+        size = static_cast<std::size_t>( file_size.QuadPart );
+        if ( size == 0 )
+            return;
+        mapping = CreateFileMappingW( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+        if ( mapping == nullptr )
+        {
+            CloseHandle( file );
+            throw std::runtime_error( "failed to map file " + path.string( ) );
+        }
+        data = static_cast<const char *>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+        if ( data == nullptr )
+        {
+            CloseHandle( mapping );
+            CloseHandle( file );
+            throw std::runtime_error( "failed to map file " + path.string( ) );
+        }
+    }
+
+    MappedFileInputSource::~MappedFileInputSource( )
+    {
+        if ( data )
+            UnmapViewOfFile( data );
+        if ( mapping )
+            CloseHandle( mapping );
+        if ( file )
+            CloseHandle( file );
+    }
+
+    static auto page_size( ) -> std::size_t
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo( &info );
+        return info.dwPageSize;
+    }
+#else
+    MappedFileInputSource::MappedFileInputSource( const std::filesystem::path &path )
+    {
+        auto fd = open( path.c_str( ), O_RDONLY );
+        if ( fd == -1 )
+            throw std::runtime_error( "failed to open file " + path.string( ) );
+        struct stat st
+        {
+        };
+        if ( fstat( fd, &st ) == -1 )
+        {
+            close( fd );
+            throw std::runtime_error( "failed to get size of file " + path.string( ) );
+        }
+        size = static_cast<std::size_t>( st.st_size );
+        if ( size == 0 )
+        {
+            close( fd );
+            return;
+        }
+        auto ptr = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        close( fd );
+        if ( ptr == MAP_FAILED )
+            throw std::runtime_error( "failed to map file " + path.string( ) );
+        madvise( ptr, size, MADV_SEQUENTIAL );
+        data = static_cast<const char *>( ptr );
+    }
+
+    MappedFileInputSource::~MappedFileInputSource( )
+    {
+        if ( data )
+            munmap( const_cast<char *>( data ), size );
+    }
+
+    static auto page_size( ) -> std::size_t
+    {
+        return static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) );
+    }
+#endif
+
+    auto MappedFileInputSource::view( ) const -> in_data_t
+    {
+        if ( data == nullptr )
+            return { };
+        return { data, size };
+    }
+
+    auto read_file( const std::filesystem::path &path ) -> std::shared_ptr<InputSource>
+    {
+        std::ifstream file( path, std::ifstream::binary );
+        if ( !file )
+            throw std::runtime_error( "failed to open file " + path.string( ) );
+        // the buffer keeps the same zeroed slack behind the content as a mapping, shrinking does not reallocate.
+        // it is never small enough for the small string buffer, whose slack would not survive the move below
+        auto size = std::filesystem::file_size( path );
+        auto data = data_t( std::max<std::size_t>( size + mapping_slack, 32 ), '\0' );
+        file.read( data.data( ), static_cast<std::streamsize>( size ) );
+        data.resize( static_cast<std::size_t>( file.gcount( ) ) );
+        return std::make_shared<StringInputSource>( std::move( data ) );
+    }
+
+    auto map_file( const std::filesystem::path &path ) -> std::shared_ptr<InputSource>
+    {
+        // the tail of the last page of a mapping is zero filled. if the file ends too close to a page boundary
+        // reading past the end would fault, so the file is read into memory instead
+        auto size = std::filesystem::file_size( path );
+        auto remainder = size % page_size( );
+        if ( size == 0 || remainder == 0 || page_size( ) - remainder < mapping_slack )
+            return read_file( path );
+        return std::make_shared<MappedFileInputSource>( path );
+    }
+} // namespace vrock::pdf
\ No newline at end of file
@@ -2,11 +2,16 @@
 #include "vrock/pdf/structure/PDFEncryption.hpp"
 #include "vrock/pdf/structure/PDFStreams.hpp"
 
+#include <vrock/utils/ThreadPool.hpp>
+
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <format>
+#include <future>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -22,15 +27,20 @@ namespace vrock::pdf
     {
     }
 
+    PDFObjectParser::PDFObjectParser( std::shared_ptr<InputSource> source )
+        : BaseParser( std::move( source ), 0 ), decryption_handler( std::make_shared<PDFNullSecurityHandler>( ) )
+    {
+    }
+
     auto PDFObjectParser::parse_object( std::shared_ptr<PDFRef> ref, bool decrypt ) -> std::shared_ptr<PDFBaseObject>
     {
         skip_comments_and_whitespaces( );
         if ( is_keyword( "true" ) )
-            return std::make_shared<PDFBool>( true );
+            return make_object<PDFBool>( arena, true );
         if ( is_keyword( "false" ) )
-            return std::make_shared<PDFBool>( false );
+            return make_object<PDFBool>( arena, false );
         if ( is_keyword( "null" ) )
-            return std::make_shared<PDFNull>( );
+            return make_object<PDFNull>( arena );
 
         if ( _string[ _offset ] == '<' && _string[ _offset + 1 ] == '<' )
             return parse_dictionary_or_stream( ref, decrypt );
@@ -52,7 +62,7 @@ namespace vrock::pdf
     {
         _offset += 2;
         skip_comments_and_whitespaces( );
-        auto dict = std::make_shared<PDFDictionary>( context );
+        auto dict = make_object<PDFDictionary>( arena, context );
         while ( _offset < _string.length( ) && _string[ _offset ] != '>' && _string[ _offset + 1 ] != '>' )
         {
             auto k = parse_name( );
@@ -79,7 +89,7 @@ namespace vrock::pdf
                 break;
             str += _string[ _offset++ ];
         }
-        return std::make_shared<PDFName>( str, true );
+        return make_object<PDFName>( arena, str, true );
     }
 
     auto PDFObjectParser::parse_hex_string( std::shared_ptr<PDFRef> ref, bool decrypt )
@@ -98,10 +108,13 @@ namespace vrock::pdf
             str += '0';
         ++_offset;
 
-        if ( decrypt )
-            return std::make_shared<PDFByteString>(
-                decryption_handler->decrypt( utils::from_hex_string<std::string>( str ), std::move( ref ) ) );
-        return std::make_shared<PDFByteString>( utils::from_hex_string<std::string>( str ) );
+        if ( decrypt && decryption_handler->is_encrypted( ) )
+        {
+            auto string = make_object<PDFByteString>( arena );
+            string->set_encrypted( utils::from_hex_string<std::string>( str ), decryption_handler, std::move( ref ) );
+            return string;
+        }
+        return make_object<PDFByteString>( arena, utils::from_hex_string<std::string>( str ) );
     }
 
     auto PDFObjectParser::parse_string( std::shared_ptr<PDFRef> ref, bool decrypt ) -> std::shared_ptr<PDFString>
@@ -149,10 +162,14 @@ namespace vrock::pdf
 
             if ( level == 0 )
             {
-                if ( decrypt )
-                    return std::make_shared<PDFUTF8String>(
-                        decryption_handler->decrypt( str.substr( 1, str.length( ) - 2 ), ref ) );
-                return std::make_shared<PDFUTF8String>( str.substr( 1, str.length( ) - 2 ) );
+                // encrypted strings are decrypted when they are read the first time
+                if ( decrypt && decryption_handler->is_encrypted( ) )
+                {
+                    auto string = make_object<PDFUTF8String>( arena, "" );
+                    string->set_encrypted( str.substr( 1, str.length( ) - 2 ), decryption_handler, ref );
+                    return string;
+                }
+                return make_object<PDFUTF8String>( arena, str.substr( 1, str.length( ) - 2 ) );
             }
         }
         throw PDFParserException( "Failed to Parse String Literal. Out of Bounds" );
@@ -162,7 +179,7 @@ namespace vrock::pdf
     {
         if ( _string[ _offset++ ] != '[' )
             throw PDFParserException( "Array does not start with '['" );
-        auto arr = std::make_shared<PDFArray>( context );
+        auto arr = make_object<PDFArray>( arena, context );
         while ( _offset < _string.length( ) && _string[ _offset ] != ']' )
         {
             arr->value.push_back( parse_object( ref, decrypt ) );
@@ -182,14 +199,14 @@ namespace vrock::pdf
             auto num2 = parse_double( );
             skip_comments_and_whitespaces( );
             if ( is_keyword( "obj" ) || _string[ _offset++ ] == 'R' )
-                return std::make_shared<PDFRef>( (int)num, (int)num2, 1 );
+                return make_object<PDFRef>( arena, (int)num, (int)num2, 1 );
         }
         _offset = tmp;
 
         double temp;
         if ( modf( num, &temp ) != 0 )
-            return std::make_shared<PDFReal>( num );
-        return std::make_shared<PDFInteger>( (int)num );
+            return make_object<PDFReal>( arena, num );
+        return make_object<PDFInteger>( arena, (int)num );
     }
 
     auto PDFObjectParser::parse_dictionary_or_stream( std::shared_ptr<PDFRef> ref, bool decrypt )
@@ -202,7 +219,7 @@ namespace vrock::pdf
             return dict;
         auto start = _offset;
         size_t end = 0;
-        if ( auto len = dict->get<PDFInteger>( "Length" ) )
+        if ( auto len = dict->get<PDFInteger>( names::Length ) )
         {
             end = start + len->value;
             _offset = end;
@@ -217,82 +234,171 @@ namespace vrock::pdf
             end = find_end_of_stream( );
         auto data = _string.substr( start, end - start );
 
-        auto type = dict->get<PDFName>( "Type" );
-        if ( type && type->name == "XRef" )
-            return std::make_shared<PDFXRefStream>( dict, data );
-        if ( type && type->name == "ObjStm" )
-            return std::make_shared<PDFObjectStream>( dict, decrypt ? decryption_handler->decrypt( data, ref ) : data,
-                                                      context );
-        return std::make_shared<PDFStream>( dict, decrypt ? decryption_handler->decrypt( data, ref ) : data );
+        auto type = dict->get<PDFName>( names::Type );
+        if ( type && type->id == names::XRef )
+            return std::make_shared<PDFXRefStream>( dict, data, _source );
+        auto encrypted = decrypt && decryption_handler->is_encrypted( );
+        if ( type && type->id == names::ObjStm )
+        {
+            // the objects are parsed from the stream right away, so it is decrypted here
+            if ( encrypted )
+                return std::make_shared<PDFObjectStream>( dict, decryption_handler->decrypt( data, ref ), context );
+            return std::make_shared<PDFObjectStream>( dict, data, context, _source );
+        }
+        // other streams view the input source and are decoded when they are accessed the first time
+        if ( encrypted )
+            return std::make_shared<PDFStream>( dict, data, _source, decryption_handler, std::move( ref ) );
+        return std::make_shared<PDFStream>( dict, data, PDFStreamType::Raw, _source );
+    }
+
+    auto PDFObjectParser::parse_indirect_object( std::size_t offset ) const -> std::shared_ptr<PDFBaseObject>
+    {
+        // objects of one indirect object usually live and die together, so they share an arena
+        auto parser = PDFObjectParser( _source );
+        parser.arena = std::make_shared<PDFObjectArena>( );
+        parser.context = context;
+        parser.decryption_handler = decryption_handler;
+        parser._offset = offset;
+        if ( auto ref = parser.parse_object( nullptr, false )->to<PDFRef>( ) )
+            return parser.parse_object( ref, true );
+        throw std::runtime_error( "failed to parse object reference" );
     }
 
     auto PDFObjectParser::find_end_of_stream( ) -> std::size_t
     {
+        // "endstream" contains "stream", so a single search finds both keywords. nested "stream" keywords increase
+        // the level like before.
+        constexpr std::string_view stream = "stream";
+        constexpr std::string_view end = "end";
         auto level = 1;
-        auto end = _offset;
-        while ( _offset < _string.length( ) )
+        auto begin = _offset;
+        while ( true )
         {
-            end = _offset;
-            if ( is_keyword( "stream" ) )
+            auto pos = find( stream, _offset );
+            if ( pos == std::string_view::npos )
+                throw PDFParserException( "Failed to Parse Stream reached end of file" );
+            _offset = pos + stream.length( );
+            if ( pos < begin + end.length( ) || _string.substr( pos - end.length( ), end.length( ) ) != end )
+            {
                 level++;
-            else if ( is_keyword( "\r\nendstream" ) || is_keyword( "\rendstream" ) || is_keyword( "\nendstream" ) ||
-                      is_keyword( "endstream" ) )
-                level--;
-            else
-                _offset++;
-            if ( level == 0 )
-                break;
+                continue;
+            }
+            if ( --level != 0 )
+                continue;
+            // the end of line marker in front of endstream is not part of the data
+            auto e = pos - end.length( );
+            if ( e >= begin + 2 && _string[ e - 2 ] == '\r' && _string[ e - 1 ] == '\n' )
+                return e - 2;
+            if ( e >= begin + 1 && ( _string[ e - 1 ] == '\r' || _string[ e - 1 ] == '\n' ) )
+                return e - 1;
+            return e;
         }
-        if ( level != 0 )
-            throw PDFParserException( "Failed to Parse Stream reached end of file" );
-        return end;
+    }
+
+    namespace
+    {
+        // classic XRef records are exactly 20 bytes: "nnnnnnnnnn ggggg n" followed by a two byte end of line
+        constexpr std::size_t xref_record_size = 20;
+        // subsections with at least this many records are decoded on the thread pool
+        constexpr std::size_t parallel_xref_records = 1 << 16;
+
+        template <std::size_t Digits>
+        inline auto parse_digits( const char *p, std::uint64_t &value ) -> bool
+        {
+            value = 0;
+            for ( std::size_t i = 0; i < Digits; ++i )
+            {
+                auto d = static_cast<unsigned char>( p[ i ] - '0' );
+                if ( d > 9 )
+                    return false;
+                value = value * 10 + d;
+            }
+            return true;
+        }
+
+        inline auto is_eol_byte( char c ) -> bool
+        {
+            return c == ' ' || c == '\r' || c == '\n';
+        }
+
+        auto parse_xref_records( const char *p, std::uint32_t start, std::size_t amount, XRefEntry *out ) -> bool
+        {
+            for ( std::size_t i = 0; i < amount; ++i, p += xref_record_size )
+            {
+                std::uint64_t offset, generation;
+                if ( !parse_digits<10>( p, offset ) || p[ 10 ] != ' ' || !parse_digits<5>( p + 11, generation ) ||
+                     p[ 16 ] != ' ' || ( p[ 17 ] != 'n' && p[ 17 ] != 'f' ) || !is_eol_byte( p[ 18 ] ) ||
+                     !is_eol_byte( p[ 19 ] ) )
+                    return false;
+                // 0: free object 1: used object correspond to f for free and n for used
+                out[ i ] = XRefEntry( static_cast<std::uint32_t>( offset ), start + static_cast<std::uint32_t>( i ),
+                                      static_cast<std::uint32_t>( generation ), p[ 17 ] == 'n' );
+            }
+            return true;
+        }
+    } // namespace
+
+    auto PDFObjectParser::find_startxref( ) -> std::size_t
+    {
+        auto start = rfind( "startxref" );
+        if ( start == std::string_view::npos )
+            throw PDFParserException( "startxref not found" );
+        _offset = start + std::string_view( "startxref" ).length( );
+        skip_comments_and_whitespaces( );
+        return parse_int( );
     }
 
     auto PDFObjectParser::parse_xref( std::size_t offset ) -> std::vector<std::shared_ptr<XRefTable>>
     {
-        std::size_t new_offset = offset;
-        std::vector<std::shared_ptr<XRefTable>> tables = { };
-        tables.emplace_back( std::make_shared<XRefTable>( ) );
-        auto &table = tables[ 0 ];
+        return parse_xref_chain( offset, nullptr );
+    }
+
+    auto PDFObjectParser::parse_xref( utils::ThreadPool &pool, std::size_t offset )
+        -> std::vector<std::shared_ptr<XRefTable>>
+    {
+        return parse_xref_chain( offset, &pool );
+    }
 
+    auto PDFObjectParser::parse_xref_chain( std::size_t offset, utils::ThreadPool *pool )
+        -> std::vector<std::shared_ptr<XRefTable>>
+    {
         if ( offset == -1 )
+            offset = find_startxref( );
+
+        // follow the Prev chain iteratively, documents with many incremental updates would recurse deeply
+        std::vector<std::shared_ptr<XRefTable>> tables = { };
+        std::unordered_set<std::size_t> visited = { };
+        while ( visited.insert( offset ).second )
         {
-            auto start = _string.find_last_of( "startxref" );
-            _offset = ++start;
-            skip_comments_and_whitespaces( );
-            new_offset = parse_int( );
-            _offset = new_offset;
+            auto &table = tables.emplace_back( parse_xref_section( offset, pool ) );
+            if ( !table->trailer || !table->trailer->has( names::Prev ) ) // there are no more XRefTables to parse
+                break;
+            auto prev = table->trailer->get<PDFInteger>( names::Prev, false );
+            if ( !prev || prev->value < 0 )
+                break;
+            offset = prev->value;
         }
+        return tables;
+    }
+
+    auto PDFObjectParser::parse_xref_section( std::size_t offset, utils::ThreadPool *pool )
+        -> std::shared_ptr<XRefTable>
+    {
+        auto table = std::make_shared<XRefTable>( );
+        _offset = offset;
 
         if ( is_keyword( "xref" ) ) // Text-based XRef table
         {
             skip_comments_and_whitespaces( );
-            std::shared_ptr<XRefEntry> entry;
-
             while ( !is_keyword( "trailer" ) )
             {
                 auto start = parse_int( );
                 skip_whitespace( );
                 auto amount = parse_int( );
                 skip_whitespace( );
-
-                table->entries.reserve( table->entries.size( ) + amount );
-
-                for ( int i = 0; i < amount; ++i )
-                {
-                    entry = std::make_shared<XRefEntry>( );
-                    entry->offset = parse_int( );
-                    skip_whitespace( );
-                    entry->generation_number = parse_int( );
-                    skip_whitespace( );
-                    entry->object_number = start + i;
-                    // 0: free object 1: used object correspond to f for free and n for used
-                    entry->type = get_char( ) == 'n';
-                    _offset++;
-                    table->entries[ entry ] = entry;
-                    skip_whitespace( );
-                }
-
+                if ( start < 0 || amount < 0 )
+                    throw PDFParserException( "invalid XRef subsection" );
+                parse_xref_subsection( *table, start, amount, pool );
                 skip_whitespace( );
             }
             skip_comments_and_whitespaces( );
@@ -304,7 +410,8 @@ namespace vrock::pdf
             auto obj = parse_object( nullptr, false );
             if ( auto stream = obj->to<PDFStream>( )->to_stream<PDFXRefStream>( ) )
             {
-                table->entries = stream->get_entries( );
+                for ( const auto &entry : stream->get_entries( ) )
+                    table->set_entry( entry );
                 table->trailer = stream->dict;
             }
             else if ( auto dict = obj->to<PDFDictionary>( ) )
@@ -312,23 +419,65 @@ namespace vrock::pdf
             else
                 throw PDFParserException( "Not a Dictionary or XRefStream" );
 
-            context->objects[ ref ] = obj;
+            context->cache.insert( ref, obj, true );
         }
+        return table;
+    }
 
-        if ( table->trailer && table->trailer->has( "Prev" ) ) // there are more XRefTables to parse
+    auto PDFObjectParser::parse_xref_subsection( XRefTable &table, std::uint32_t start, std::uint32_t amount,
+                                                 utils::ThreadPool *pool ) -> void
+    {
+        // well formed subsections are decoded without the tokenizer, split into chunks for very large tables
+        if ( amount != 0 && _offset + amount * xref_record_size <= _string.size( ) )
         {
-            if ( auto prev = table->trailer->get<PDFInteger>( "Prev", false ) )
+            auto records = std::vector<XRefEntry>( amount );
+            auto data = _string.data( ) + _offset;
+            auto chunks = pool && amount >= parallel_xref_records
+                              ? std::min<std::size_t>( pool->size( ) + 1, amount / ( parallel_xref_records / 2 ) )
+                              : 1;
+            auto chunk_size = ( amount + chunks - 1 ) / chunks;
+            auto ok = std::vector<char>( chunks, false );
+            auto decode = [ & ]( std::size_t chunk ) {
+                auto first = chunk * chunk_size;
+                auto count = std::min<std::size_t>( chunk_size, amount - first );
+                ok[ chunk ] = parse_xref_records( data + first * xref_record_size,
+                                                  start + static_cast<std::uint32_t>( first ), count,
+                                                  records.data( ) + first );
+            };
+            {
+                // the calling thread decodes the first chunk, the records and ok outlive every task
+                std::vector<std::future<void>> futures;
+                futures.reserve( chunks - 1 );
+                for ( std::size_t chunk = 1; chunk < chunks; ++chunk )
+                    futures.push_back( pool->submit( decode, chunk ) );
+                decode( 0 );
+                for ( auto &future : futures )
+                    future.get( );
+            }
+            if ( std::ranges::all_of( ok, []( char c ) { return c; } ) )
             {
-                if ( prev->value == new_offset )
-                    return tables;
-                _offset = prev->value;
-                auto prev_tables = parse_xref( prev->value );
-                tables.reserve( prev_tables.size( ) + 1 );
-                for ( auto &t : prev_tables )
-                    tables.push_back( t );
+                table.reserve( start + amount );
+                for ( const auto &entry : records )
+                    table.set_entry( entry );
+                _offset += amount * xref_record_size;
+                return;
             }
         }
-        return tables;
+
+        XRefEntry entry;
+        for ( std::uint32_t i = 0; i < amount; ++i )
+        {
+            entry.offset = parse_int( );
+            skip_whitespace( );
+            entry.generation_number = parse_int( );
+            skip_whitespace( );
+            entry.object_number = start + i;
+            // 0: free object 1: used object correspond to f for free and n for used
+            entry.type = get_char( ) == 'n';
+            _offset++;
+            table.set_entry( entry );
+            skip_whitespace( );
+        }
     }
 
 } // namespace vrock::pdf
\ No newline at end of file
@@ -7,15 +7,15 @@ namespace vrock::pdf
 
     Font::Font( std::shared_ptr<PDFDictionary> dict )
     {
-        if ( auto type = dict->get<PDFName>( "Subtype" ) )
-            if ( font_types.contains( type->name ) )
-                font_type = font_types[ type->name ];
+        if ( auto type = dict->get<PDFName>( names::Subtype ) )
+            if ( auto it = font_types.find( type->name ); it != font_types.end( ) )
+                font_type = it->second;
 
         if ( auto first = dict->get<PDFInteger>( "FirstChar" ) )
             first_char = first->value;
         if ( auto last = dict->get<PDFInteger>( "FirstChar" ) )
             last_char = last->value;
-        if ( auto base = dict->get<PDFName>( "BaseFont" ) )
+        if ( auto base = dict->get<PDFName>( names::BaseFont ) )
             base_font = base->name;
         if ( auto name = dict->get<PDFName>( "Name" ) )
             font_name = name->name;
@@ -39,7 +39,7 @@ namespace vrock::pdf
     SampledFunction::SampledFunction( std::shared_ptr<PDFStream> stream ) : Function( stream->dict )
     {
         // Size
-        if ( auto size_arr = stream->dict->get<PDFArray>( "Size" ) )
+        if ( auto size_arr = stream->dict->get<PDFArray>( names::Size ) )
             for ( auto &e : size_arr->value )
                 if ( auto num = e->to<PDFNumber>( ) )
                     size.emplace_back( num->as_int( ) );
@@ -3,6 +3,13 @@
 #include "vrock/pdf/parser/PDFObjectParser.hpp"
 #include "vrock/pdf/structure/PDFStreams.hpp"
 
+#include <vrock/utils/ThreadPool.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <unordered_set>
+
 namespace vrock::pdf
 {
     XRefEntry::XRefEntry( std::uint32_t offset, std::uint32_t object_number, std::uint32_t gen_num, std::uint8_t type )
@@ -10,29 +17,33 @@ namespace vrock::pdf
     {
     }
 
-    size_t XRefEntryPtrHash::operator( )( const std::shared_ptr<XRefEntry> &r ) const
+    auto XRefTable::set_entry( const XRefEntry &entry ) -> void
     {
-        return std::hash<std::uint32_t>( )( r->object_number );
+        if ( entry.object_number > XRefEntry::max_object_number )
+            throw std::runtime_error( "object number in XRef table out of range" );
+        if ( entry.object_number >= entries.size( ) )
+            entries.resize( entry.object_number + 1, XRefEntry( 0, 0, 0, XRefEntry::missing ) );
+        if ( entries[ entry.object_number ].type == XRefEntry::missing )
+            ++count;
+        entries[ entry.object_number ] = entry;
+        // unknown types are references to the null object, like free entries
+        if ( entry.type > 2 )
+            entries[ entry.object_number ].type = 0;
     }
 
-    bool XRefEntryPtrEqual::operator( )( const std::shared_ptr<XRefEntry> &l,
-                                         const std::shared_ptr<XRefEntry> &r ) const
+    auto XRefTable::reserve( std::size_t size ) -> void
     {
-        if ( r->type == 2 || l->type == 2 )
-            return l->object_number == r->object_number;
-        return l->object_number == r->object_number && l->generation_number == r->generation_number;
+        if ( size > entries.size( ) )
+            entries.resize( std::min<std::size_t>( size, XRefEntry::max_object_number + 1 ),
+                            XRefEntry( 0, 0, 0, XRefEntry::missing ) );
     }
 
-    auto XRefTable::get_entry( const std::shared_ptr<PDFRef> &ref ) -> std::shared_ptr<XRefEntry>
+    auto XRefTable::merge( const XRefTable &newer ) -> void
     {
-        auto entry = std::make_shared<XRefEntry>( 0, ref->object_number, ref->generation_number, 1 );
-        if ( entries.contains( entry ) )
-        {
-            auto e = entries[ entry ];
-            if ( e->type != 0 )
-                return e;
-        }
-        return nullptr;
+        reserve( newer.entries.size( ) );
+        for ( const auto &entry : newer.entries )
+            if ( entry.type != XRefEntry::missing )
+                set_entry( entry );
     }
 
     PDFContext::PDFContext( std::shared_ptr<PDFObjectParser> parser ) : parser( std::move( parser ) )
@@ -41,26 +52,164 @@ namespace vrock::pdf
 
     auto PDFContext::init( ) -> void
     {
-        xref_tables = std::move( parser->parse_xref( ) );
+        startxref = parser->find_startxref( );
+        init_tables( parser->parse_xref( startxref ) );
+    }
+
+    auto PDFContext::init( utils::ThreadPool &pool ) -> void
+    {
+        startxref = parser->find_startxref( );
+        init_tables( parser->parse_xref( pool, startxref ) );
+    }
+
+    auto PDFContext::init_tables( std::vector<std::shared_ptr<XRefTable>> tables ) -> void
+    {
+        xref_tables = std::move( tables );
         trailer = xref_tables[ 0 ]->trailer;
+        xref = XRefTable( );
+        for ( auto it = xref_tables.rbegin( ); it != xref_tables.rend( ); ++it )
+            xref.merge( **it );
+        xref.trailer = trailer;
+
+        next_object_number = std::max<std::uint32_t>( 1, xref.entries.size( ) );
+        if ( auto size = trailer->get<PDFInteger>( names::Size, false ); size && size->value > 0 )
+            next_object_number = std::max<std::uint32_t>( next_object_number, size->value );
+    }
+
+    namespace
+    {
+        // changes of direct objects make the indirect object containing them modified
+        auto is_modified( const std::shared_ptr<PDFBaseObject> &obj ) -> bool
+        {
+            if ( obj == nullptr )
+                return false;
+            if ( obj->modified )
+                return true;
+            if ( auto dict = obj->to<PDFDictionary>( ) )
+                return std::ranges::any_of( dict->dict,
+                                            []( const auto &entry ) { return is_modified( entry.second ); } );
+            if ( auto arr = obj->to<PDFArray>( ) )
+                return std::ranges::any_of( arr->value, is_modified );
+            if ( auto stream = obj->to<PDFStream>( ) )
+                return is_modified( stream->dict );
+            return false;
+        }
+
+        auto reset_modified( const std::shared_ptr<PDFBaseObject> &obj ) -> void
+        {
+            if ( obj == nullptr )
+                return;
+            obj->modified = false;
+            if ( auto dict = obj->to<PDFDictionary>( ) )
+                for ( const auto &[ key, value ] : dict->dict )
+                    reset_modified( value );
+            else if ( auto arr = obj->to<PDFArray>( ) )
+                for ( const auto &item : arr->value )
+                    reset_modified( item );
+            else if ( auto stream = obj->to<PDFStream>( ) )
+                reset_modified( stream->dict );
+        }
+    } // namespace
+
+    auto PDFContext::add_object( std::shared_ptr<PDFBaseObject> obj ) -> std::shared_ptr<PDFRef>
+    {
+        auto ref = std::make_shared<PDFRef>( next_object_number++, 0, 1 );
+        cache.insert( ref, std::move( obj ), true );
+        marked.push_back( ref );
+        return ref;
+    }
+
+    auto PDFContext::mark_modified( const std::shared_ptr<PDFRef> &ref ) -> void
+    {
+        if ( auto obj = cache.get( ref ) )
+        {
+            cache.insert( ref, obj, true );
+            marked.push_back( ref );
+        }
+    }
+
+    auto PDFContext::get_modified_objects( )
+        -> std::vector<std::pair<std::shared_ptr<PDFRef>, std::shared_ptr<PDFBaseObject>>>
+    {
+        std::vector<std::pair<std::shared_ptr<PDFRef>, std::shared_ptr<PDFBaseObject>>> objects;
+        std::unordered_set<std::shared_ptr<PDFRef>, PDFRefPtrHash, PDFRefPtrEqual> seen;
+        for ( const auto &ref : marked )
+            if ( auto obj = cache.get( ref ); obj && seen.insert( ref ).second )
+                objects.emplace_back( ref, obj );
+        cache.for_each( [ & ]( const std::shared_ptr<PDFRef> &ref, const std::shared_ptr<PDFBaseObject> &obj ) {
+            if ( !seen.contains( ref ) && is_modified( obj ) )
+            {
+                seen.insert( ref );
+                objects.emplace_back( ref, obj );
+            }
+        } );
+        std::ranges::sort( objects, []( const auto &l, const auto &r ) {
+            return l.first->object_number < r.first->object_number;
+        } );
+        return objects;
+    }
+
+    auto PDFContext::clear_modified( std::size_t offset ) -> void
+    {
+        for ( const auto &[ ref, obj ] : get_modified_objects( ) )
+        {
+            reset_modified( obj );
+            cache.insert( ref, obj, true );
+        }
+        marked.clear( );
+        startxref = offset;
+    }
+
+    auto PDFContext::prefetch_object_streams( utils::ThreadPool &pool ) -> std::size_t
+    {
+        // the offset of a compressed object is the object number of its object stream
+        std::vector<std::uint32_t> streams;
+        std::vector<bool> seen( xref.entries.size( ), false );
+        for ( const auto &entry : xref.entries )
+            if ( entry.type == 2 && entry.offset < seen.size( ) && !seen[ entry.offset ] )
+            {
+                seen[ entry.offset ] = true;
+                streams.push_back( entry.offset );
+            }
+
+        std::vector<std::future<void>> futures;
+        futures.reserve( streams.size( ) );
+        for ( auto number : streams )
+            futures.push_back(
+                pool.submit( [ this, number ] { get_object( std::make_shared<PDFRef>( number, 0, 1 ) ); } ) );
+
+        // every task has to finish before an error is reported, they reference this context
+        std::exception_ptr error;
+        for ( auto &future : futures )
+        {
+            try
+            {
+                future.get( );
+            }
+            catch ( ... )
+            {
+                if ( !error )
+                    error = std::current_exception( );
+            }
+        }
+        if ( error )
+            std::rethrow_exception( error );
+        return streams.size( );
     }
 
     auto PDFContext::get_object( const std::shared_ptr<PDFRef> &ref ) -> std::shared_ptr<PDFBaseObject>
     {
         if ( ref == nullptr )
             return nullptr;
-        if ( objects.contains( ref ) )
-            return objects[ ref ];
+        if ( auto obj = cache.get( ref ) )
+            return obj;
 
-        std::shared_ptr<XRefEntry> entry = nullptr;
-        for ( const auto &table : xref_tables )
-        {
-            entry = table->get_entry( ref );
-            if ( entry )
-                break;
-        }
+        auto entry = xref.get_entry( ref->object_number );
+        // generation numbers only have to match for uncompressed objects
+        if ( entry && entry->type == 1 && entry->generation_number != ref->generation_number )
+            entry = nullptr;
 
-        if ( entry )
+        if ( entry && entry->type != 0 )
         {
             std::shared_ptr<PDFBaseObject> obj;
 
@@ -69,14 +218,9 @@ namespace vrock::pdf
             case 0:
                 obj = std::make_shared<PDFNull>( );
                 break;
-            case 1: {
-                parser->_offset = entry->offset;
-                if ( auto ref = parser->parse_object( nullptr, false )->to<PDFRef>( ) )
-                    obj = parser->parse_object( ref, true );
-                else
-                    throw std::runtime_error( "failed to parse object reference" );
+            case 1:
+                obj = parser->parse_indirect_object( entry->offset );
                 break;
-            }
             case 2: {
                 // get stream + convert
                 if ( auto objstm = get_object<PDFStream>( std::make_shared<PDFRef>( entry->offset, 0, 1 ) )
@@ -88,8 +232,8 @@ namespace vrock::pdf
                 obj = std::make_shared<PDFNull>( );
             }
 
-            objects[ ref ] = obj;
-            return obj;
+            // another thread may have resolved the same object in the meantime
+            return cache.insert_or_get( ref, obj );
         }
         return nullptr;
     }
@@ -7,6 +7,7 @@
 #include <unicode/usprep.h>
 #include <unicode/ustring.h>
 
+#include <algorithm>
 #include <cstring>
 #include <functional>
 #include <memory>
@@ -15,6 +16,52 @@
 
 namespace vrock::pdf
 {
+    namespace
+    {
+        // the security functions take mutable spans, keys and initialization vectors are only read
+        auto as_bytes( in_data_t data ) -> security::byte_span_t
+        {
+            return { reinterpret_cast<std::uint8_t *>( const_cast<char *>( data.data( ) ) ), data.size( ) };
+        }
+
+        // decrypts a copy of data in place, which is the only copy made
+        auto decrypt_with_key( in_data_t data, in_data_t key, bool use_aes ) -> data_t
+        {
+            if ( !use_aes )
+            {
+                auto decrypted = data_t( data );
+                security::decrypt_rc4_in_place( as_bytes( decrypted ), as_bytes( key ) );
+                return decrypted;
+            }
+            if ( data.size( ) < 16 )
+                return { };
+            // an incomplete last block can not be decrypted and is dropped
+            auto iv = data.substr( 0, 16 );
+            auto decrypted = data_t( data.substr( 16, ( data.size( ) - 16 ) / 16 * 16 ) );
+            security::decrypt_aes_cbc_in_place( as_bytes( decrypted ), as_bytes( key ), as_bytes( iv ) );
+
+            // remove the PKCS#5 padding, data with invalid padding is kept as it is
+            if ( decrypted.empty( ) )
+                return decrypted;
+            auto padding = static_cast<std::uint8_t>( decrypted.back( ) );
+            if ( padding >= 1 && padding <= 16 &&
+                 std::all_of( decrypted.end( ) - padding, decrypted.end( ),
+                              [ padding ]( char c ) { return static_cast<std::uint8_t>( c ) == padding; } ) )
+                decrypted.resize( decrypted.size( ) - padding );
+            return decrypted;
+        }
+
+        auto encrypt_with_key( in_data_t data, in_data_t key, bool use_aes ) -> data_t
+        {
+            if ( !use_aes )
+                return security::encrypt_rc4( data, key );
+            auto bytes = security::generate_random_bytes( 16 );
+            auto iv = utils::to_string( bytes );
+            iv.append( security::encrypt_aes_cbc( data, key, iv, security::Padding::PkcsPadding ) );
+            return iv;
+        }
+    } // namespace
+
     PDFNullSecurityHandler::PDFNullSecurityHandler( ) : PDFBaseSecurityHandler( SecurityHandlerType::Null )
     {
     }
@@ -78,10 +125,10 @@ namespace vrock::pdf
         case 2:
         case 3:
         case 4:
-            return decrypt_data_1( data, ref, key, use_aes );
+            return decrypt_with_key( data, get_object_key( ref ), use_aes );
         case 5:
         case 6:
-            return decrypt_data_1a( data, key );
+            return decrypt_with_key( data, key, true );
         case 7: {
             auto iv = data.substr( 0, 12 );
             auto encrypted = data.substr( 12, data.size( ) - 12 - 16 );
@@ -100,7 +147,7 @@ namespace vrock::pdf
         case 2:
         case 3:
         case 4:
-            return encrypt_data_1( data, ref, key, use_aes );
+            return encrypt_with_key( data, get_object_key( ref ), use_aes );
         case 5:
         case 6:
             return encrypt_data_1a( data, key );
@@ -160,7 +207,7 @@ namespace vrock::pdf
 
     auto PDFStandardSecurityHandler::authenticate( const std::string &password ) -> AuthenticationState
     {
-        auto i = context->trailer->get<PDFArray>( "ID" );
+        auto i = context->trailer->get<PDFArray>( names::ID );
         if ( i || revision > 4 )
         {
             auto id = i->get<PDFString>( 0 )->get_data( );
@@ -168,7 +215,7 @@ namespace vrock::pdf
             if ( !k.empty( ) )
             {
                 state = AuthenticationState::Owner;
-                key = k;
+                set_key( k );
                 fn( );
                 return state;
             }
@@ -176,7 +223,7 @@ namespace vrock::pdf
             if ( !k.empty( ) )
             {
                 state = AuthenticationState::User;
-                key = k;
+                set_key( k );
                 fn( );
                 return state;
             }
@@ -215,42 +262,50 @@ namespace vrock::pdf
         return security::md5( k );
     }
 
+    auto PDFStandardSecurityHandler::get_object_key( const std::shared_ptr<PDFRef> &ref ) -> data_t
+    {
+        auto id = static_cast<std::uint64_t>( ref->object_number ) << 32 | ref->generation_number;
+        std::lock_guard lock( object_keys_mutex );
+        // an object only replaces the key of the object sharing its slot
+        auto &slot = object_keys[ ref->object_number % object_keys.size( ) ];
+        if ( slot.id != id )
+        {
+            slot.key = pdf::get_object_key( ref, key, use_aes );
+            slot.key.resize( std::min( key.size( ) + 5, (size_t)16 ) );
+            slot.id = id;
+        }
+        return slot.key;
+    }
+
+    auto PDFStandardSecurityHandler::set_key( data_t k ) -> void
+    {
+        std::lock_guard lock( object_keys_mutex );
+        key = std::move( k );
+        object_keys.fill( { } );
+    }
+
     auto encrypt_data_1( in_data_t data, const std::shared_ptr<PDFRef> &ref, in_data_t key, bool use_aes ) -> data_t
     {
         auto obj_key = get_object_key( ref, key, use_aes );
         obj_key = obj_key.substr( 0, std::min( key.size( ) + 5, (size_t)16 ) );
-        if ( !use_aes )
-            return security::encrypt_rc4( data, obj_key );
-        auto bytes = security::generate_random_bytes( 16 );
-        auto iv = utils::to_string( bytes );
-        iv.append( security::encrypt_aes_cbc( data, obj_key, iv ) );
-        return iv;
+        return encrypt_with_key( data, obj_key, use_aes );
     }
 
     auto encrypt_data_1a( in_data_t data, in_data_t key ) -> data_t
     {
-        auto bytes = security::generate_random_bytes( 16 );
-        auto iv = utils::to_string( bytes );
-        iv.append( security::encrypt_aes_cbc( data, key, iv ) );
-        return iv;
+        return encrypt_with_key( data, key, true );
     }
 
     auto decrypt_data_1( in_data_t data, std::shared_ptr<PDFRef> ref, in_data_t key, bool use_aes ) -> data_t
     {
         auto obj_key = get_object_key( ref, key, use_aes );
         obj_key = obj_key.substr( 0, std::min( key.size( ) + 5, (size_t)16 ) );
-        if ( !use_aes )
-            return security::decrypt_rc4( data, obj_key );
-        auto iv = data.substr( 0, 16 );
-        auto encrypted = data.substr( 16 );
-        return security::decrypt_aes_cbc( encrypted, obj_key, iv );
+        return decrypt_with_key( data, obj_key, use_aes );
     }
 
     auto decrypt_data_1a( in_data_t data, in_data_t key ) -> data_t
     {
-        auto iv = data.substr( 0, 16 );
-        auto encrypted = data.substr( 16 );
-        return security::decrypt_aes_cbc( encrypted, key, iv );
+        return decrypt_with_key( data, key, true );
     }
 
     void pad_or_truncate_password( data_t &out, const std::string &pw, size_t pos = 0 )
@@ -511,7 +566,7 @@ namespace vrock::pdf
     auto authenticate_user_password_6( const std::string &password, const std::shared_ptr<PDFDictionary> &dict,
                                        in_data_t id ) -> data_t
     {
-        auto len = dict->get<PDFInteger>( "Length" );
+        auto len = dict->get<PDFInteger>( names::Length );
         auto u = dict->get<PDFString>( "U" ); // 32 byte
         auto r = dict->get<PDFInteger>( "R" );
         auto o = dict->get<PDFString>( "O" );  // 32 byte
@@ -545,7 +600,7 @@ namespace vrock::pdf
     auto authenticate_owner_password_7( const std::string &password, const std::shared_ptr<PDFDictionary> &dict,
                                         in_data_t id ) -> data_t
     {
-        auto len = dict->get<PDFInteger>( "Length" );
+        auto len = dict->get<PDFInteger>( names::Length );
         auto r = dict->get<PDFInteger>( "R" );
         auto o = dict->get<PDFString>( "O" ); // 32 byte
 
@@ -6,8 +6,9 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
-#include <iostream>
 #include <memory>
 #include <vector>
 
@@ -38,27 +39,48 @@ namespace vrock::pdf
 
     auto PDFFlateFilter::encode( in_data_t data, std::shared_ptr<PDFDictionary> ) -> data_t
     {
-        return data_t( data );
+        return deflate( data, level, pool.get( ), parallel_threshold );
     }
 
-    auto predict_png( const in_data_t &data, int col, int bpc, int bpp ) -> data_t;
-
     auto PDFFlateFilter::decode( in_data_t data, std::shared_ptr<PDFDictionary> params ) -> data_t
+    {
+        return decode( data, std::move( params ), 0 );
+    }
+
+    auto get_predictor( const std::shared_ptr<PDFDictionary> &params ) -> int
+    {
+        if ( params )
+            if ( auto pred = params->get<PDFNumber>( names::Predictor ) )
+                return pred->as_int( );
+        return 1;
+    }
+
+    auto PDFFlateFilter::decode_to( in_data_t data, std::shared_ptr<PDFDictionary> params,
+                                    const consumer_t &consumer ) -> void
+    {
+        // predictors depend on the previous row, so predicted data is decoded as a whole
+        if ( get_predictor( params ) >= 10 )
+            consumer( decode( data, std::move( params ) ) );
+        else
+            inflate( data, consumer );
+    }
+
+    auto PDFFlateFilter::decode( in_data_t data, std::shared_ptr<PDFDictionary> params, std::size_t size_hint )
+        -> data_t
     {
         int predictor = 1;
         int colors = 1;
         int bit_per_component = 8;
         int columns = 1;
-        if ( auto pred = params->get<PDFNumber>( "Predictor" ) )
+        if ( auto pred = params->get<PDFNumber>( names::Predictor ) )
             predictor = pred->as_int( );
-        if ( auto color = params->get<PDFNumber>( "Colors" ) )
+        if ( auto color = params->get<PDFNumber>( names::Colors ) )
             colors = color->as_int( );
-        if ( auto bpc = params->get<PDFNumber>( "BitsPerComponent" ) )
+        if ( auto bpc = params->get<PDFNumber>( names::BitsPerComponent ) )
             bit_per_component = bpc->as_int( );
-        if ( auto col = params->get<PDFNumber>( "Columns" ) )
+        if ( auto col = params->get<PDFNumber>( names::Columns ) )
             columns = col->as_int( );
-        auto pixel_length = ( colors * bit_per_component + 7 ) / 8;
-        auto inflated = inflate( data );
+        auto inflated = inflate( data, predictor >= 10 ? 0 : size_hint );
         // apply predictor
         switch ( predictor )
         {
@@ -68,7 +90,9 @@ namespace vrock::pdf
         case 11:
         case 12:
         case 13:
-            return predict_png( inflated, columns, bit_per_component, pixel_length );
+        case 14:
+        case 15:
+            return predict_png( inflated, columns, colors, bit_per_component );
         default:
             // log::get_logger( "pdf" )->log->info( "unknown predictor {}", predictor );
             return inflated;
@@ -80,53 +104,188 @@ namespace vrock::pdf
         return data_t( data );
     }
 
-    auto PDFDCTFilter::decode( in_data_t data, std::shared_ptr<PDFDictionary> dict ) -> data_t
+    namespace
     {
-        if ( auto color_transform = dict->get<PDFInteger>( "ColorTransform" ) )
-            std::cout << color_transform->value << std::endl;
+        struct JPEGInfo
+        {
+            int components = 0;
+            bool adobe = false;
+        };
+
+        // walks the marker segments up to the first frame header
+        auto read_jpeg_info( in_data_t data ) -> JPEGInfo
+        {
+            JPEGInfo info;
+            auto byte = [ & ]( std::size_t i ) { return static_cast<std::uint8_t>( data[ i ] ); };
+            std::size_t pos = 2;
+            while ( pos + 4 <= data.size( ) && byte( pos ) == 0xFF )
+            {
+                auto marker = byte( pos + 1 );
+                if ( marker == 0xFF )
+                {
+                    ++pos;
+                    continue;
+                }
+                auto length = static_cast<std::size_t>( byte( pos + 2 ) << 8 | byte( pos + 3 ) );
+                if ( marker == 0xEE && length >= 7 && data.substr( pos + 4, 5 ) == "Adobe" )
+                    info.adobe = true;
+                // start of frame markers, except DHT, JPG and DAC which share the range
+                if ( marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC )
+                {
+                    if ( pos + 10 <= data.size( ) )
+                        info.components = byte( pos + 9 );
+                    break;
+                }
+                pos += 2 + length;
+            }
+            return info;
+        }
+    } // namespace
+
+    auto PDFDCTFilter::decode( in_data_t data, std::shared_ptr<PDFDictionary> params ) -> data_t
+    {
+        if ( data.size( ) < 4 || static_cast<std::uint8_t>( data[ 0 ] ) != 0xFF ||
+             static_cast<std::uint8_t>( data[ 1 ] ) != 0xD8 )
+            throw std::runtime_error( "invalid DCT encoded data" );
+        auto info = read_jpeg_info( data );
+
+        // an Adobe marker takes precedence over ColorTransform. without one the decoder only knows the transform if
+        // it is passed in a marker inserted behind the start of image
+        data_t patched;
+        if ( !info.adobe && info.components >= 3 )
+        {
+            auto transform = info.components == 3 ? 1 : 0;
+            if ( params )
+                if ( auto color_transform = params->get<PDFInteger>( "ColorTransform" ) )
+                    transform = color_transform->value;
+            if ( info.components == 4 || transform != 1 )
+            {
+                patched.reserve( data.size( ) + 16 );
+                patched += data.substr( 0, 2 );
+                patched += std::string_view( "\xFF\xEE\x00\x0E"
+                                             "Adobe\x00\x64\x00\x00\x00\x00",
+                                             15 );
+                patched += static_cast<char>( transform );
+                patched += data.substr( 2 );
+                data = patched;
+            }
+        }
+
+        // CMYK and YCCK images are converted to RGB by the decoder
+        auto channels = info.components >= 3 ? 3 : 1;
         int w = 0, h = 0, c = 0;
-        auto i = stbi_load_from_memory( reinterpret_cast<unsigned char const *>( data.data( ) ), data.size( ), &w, &h,
-                                        &c, 3 );
-        auto d = data_t( w * c * h, '\0' );
-        std::memcpy( (void *)data.data( ), i, data.size( ) );
-        stbi_image_free( i );
-        return d;
+        auto pixels = stbi_load_from_memory( reinterpret_cast<const stbi_uc *>( data.data( ) ),
+                                             static_cast<int>( data.size( ) ), &w, &h, &c, channels );
+        if ( pixels == nullptr )
+            throw std::runtime_error( std::string( "DCT decoding failed: " ) + stbi_failure_reason( ) );
+        auto decoded = data_t( reinterpret_cast<const char *>( pixels ),
+                               static_cast<std::size_t>( w ) * static_cast<std::size_t>( h ) * channels );
+        stbi_image_free( pixels );
+        return decoded;
     }
 
-    auto predict_png( const in_data_t &data, int col, int bpc, int bpp ) -> data_t
+    namespace
     {
-        auto row_len = ( col * bpp ) + 1;
-        size_t len = col * bpp;
-        auto rows = ( data.size( ) / row_len );
-        auto decoded = data_t( rows * col, '\0' );
+        // the row kernels work on raw pointers without bounds checks so the simple ones can be vectorized by the
+        // compiler. prev points to a row of zeros for the first row.
+        using byte_t = std::uint8_t;
+
+        inline auto predict_sub( const byte_t *in, byte_t *out, std::size_t len, std::size_t bpp ) -> void
+        {
+            std::memcpy( out, in, std::min( bpp, len ) );
+            for ( std::size_t j = bpp; j < len; ++j )
+                out[ j ] = in[ j ] + out[ j - bpp ];
+        }
 
-        for ( size_t i = 0; i < rows; i++ )
+        inline auto predict_up( const byte_t *in, const byte_t *prev, byte_t *out, std::size_t len ) -> void
         {
-            auto pred = data.data( )[ i * row_len ];
-            auto row_start_o = row_len * i + 1;
-            auto row_start_d = len * i;
+            for ( std::size_t j = 0; j < len; ++j )
+                out[ j ] = in[ j ] + prev[ j ];
+        }
+
+        inline auto predict_average( const byte_t *in, const byte_t *prev, byte_t *out, std::size_t len,
+                                     std::size_t bpp ) -> void
+        {
+            auto first = std::min( bpp, len );
+            for ( std::size_t j = 0; j < first; ++j )
+                out[ j ] = in[ j ] + ( prev[ j ] >> 1 );
+            for ( std::size_t j = bpp; j < len; ++j )
+                out[ j ] = in[ j ] + ( ( out[ j - bpp ] + prev[ j ] ) >> 1 );
+        }
 
-            switch ( pred )
+        inline auto paeth( int a, int b, int c ) -> byte_t
+        {
+            auto p = b - c;
+            auto q = a - c;
+            auto pa = std::abs( p );
+            auto pb = std::abs( q );
+            auto pc = std::abs( p + q );
+            if ( pa <= pb && pa <= pc )
+                return a;
+            return pb <= pc ? b : c;
+        }
+
+        inline auto predict_paeth( const byte_t *in, const byte_t *prev, byte_t *out, std::size_t len,
+                                   std::size_t bpp ) -> void
+        {
+            // left and upper left are zero for the first pixel, so paeth always selects the upper byte
+            auto first = std::min( bpp, len );
+            for ( std::size_t j = 0; j < first; ++j )
+                out[ j ] = in[ j ] + prev[ j ];
+            for ( std::size_t j = bpp; j < len; ++j )
+                out[ j ] = in[ j ] + paeth( out[ j - bpp ], prev[ j ], prev[ j - bpp ] );
+        }
+    } // namespace
+
+    auto predict_png( in_data_t data, int columns, int colors, int bpc ) -> data_t
+    {
+        if ( columns <= 0 || colors <= 0 || bpc <= 0 || bpc > 16 )
+            throw std::runtime_error( "invalid PNG predictor parameters" );
+        if ( data.empty( ) )
+            return { };
+        // the row length is checked against the input before anything is allocated for it
+        auto samples = static_cast<std::size_t>( columns ) * static_cast<std::size_t>( colors );
+        if ( samples > data.size( ) * 8 )
+            throw std::runtime_error( "PNG predictor row is longer than the data" );
+        std::size_t len = ( samples * bpc + 7 ) / 8;
+        if ( len >= data.size( ) )
+            throw std::runtime_error( "PNG predictor row is longer than the data" );
+        // bytes per complete pixel, at least one for bpc < 8
+        std::size_t bpp = std::max<std::size_t>( 1, ( static_cast<std::size_t>( colors ) * bpc + 7 ) / 8 );
+        auto rows = data.size( ) / ( len + 1 );
+        auto decoded = data_t( rows * len, '\0' );
+
+        auto zero = std::vector<byte_t>( len, 0 );
+        auto in = reinterpret_cast<const byte_t *>( data.data( ) );
+        auto out = reinterpret_cast<byte_t *>( decoded.data( ) );
+        const byte_t *prev = zero.data( );
+
+        for ( std::size_t i = 0; i < rows; i++, in += len + 1, out += len )
+        {
+            // every row starts with its own filter type
+            switch ( in[ 0 ] )
             {
             case 0:
-                std::memcpy( decoded.data( ) + row_start_d, data.data( ) + row_start_o, len );
+                std::memcpy( out, in + 1, len );
+                break;
             case 1:
-                std::memcpy( decoded.data( ) + row_start_d, data.data( ) + row_start_o, bpp );
-                for ( size_t j = bpp; j < len; j++ )
-                    decoded.at( row_start_d + j ) = data.at( row_start_o + j ) + decoded.at( row_start_d + j - bpp );
+                predict_sub( in + 1, out, len, bpp );
                 break;
             case 2:
-                if ( i != 0 )
-                    for ( int j = 0; j < col; j++ )
-                        decoded.at( row_start_d + j ) =
-                            data.at( row_start_o + j ) + decoded.at( row_start_d - len + j );
-                else
-                    std::memcpy( decoded.data( ), data.data( ) + 1, col );
+                predict_up( in + 1, prev, out, len );
+                break;
+            case 3:
+                predict_average( in + 1, prev, out, len, bpp );
+                break;
+            case 4:
+                predict_paeth( in + 1, prev, out, len, bpp );
                 break;
             default:
-                vrock::log::get_logger( "pdf" )->error( "PNG predictor {} not supported!", pred );
+                vrock::log::get_logger( "pdf" )->error( "PNG predictor {} not supported!", in[ 0 ] );
+                std::memcpy( out, in + 1, len );
                 break;
             }
+            prev = out;
         }
         return decoded;
     }
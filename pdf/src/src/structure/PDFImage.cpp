@@ -1,10 +1,13 @@
 #include "vrock/pdf/structure/PDFImage.hpp"
 
-#include <stb_image_write.h>
+#include "vrock/pdf/structure/PDFFilters.hpp"
 
-#include <utility>
+#include <stb_image_write.h>
 
 #include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
 
 namespace vrock::pdf
 {
@@ -14,7 +17,7 @@ namespace vrock::pdf
             width = w->value;
         if ( auto h = stream->dict->get<PDFInteger>( "Height" ) )
             height = h->value;
-        if ( auto b = stream->dict->get<PDFInteger>( "BitsPerComponent" ) )
+        if ( auto b = stream->dict->get<PDFInteger>( names::BitsPerComponent ) )
             bpp = b->value;
 
         // Colorspace
@@ -23,13 +26,51 @@ namespace vrock::pdf
 
     auto PDFImage::save( const std::string &path, ImageSaveFormat format ) -> void
     {
-        auto rgba = as_rgba( );
         switch ( format )
         {
-        case ImageSaveFormat::png:
+        case ImageSaveFormat::png: {
+            auto rgba = as_rgba( );
             stbi_write_png( path.c_str( ), width, height, 4, rgba.data( ), rgba.size( ) / height );
             break;
         }
+        case ImageSaveFormat::jpeg:
+            if ( is_jpeg( ) )
+            {
+                std::ofstream file( path, std::ofstream::binary | std::ofstream::trunc );
+                if ( !file )
+                    throw std::runtime_error( "failed to open file " + path );
+                auto jpeg = stream->decode( );
+                file.write( jpeg.data( ), static_cast<std::streamsize>( jpeg.size( ) ) );
+                if ( !file )
+                    throw std::runtime_error( "failed to write file " + path );
+            }
+            else
+            {
+                auto rgb = as_rgb( );
+                stbi_write_jpg( path.c_str( ), width, height, 3, rgb.data( ), 90 );
+            }
+            break;
+        }
+    }
+
+    auto PDFImage::as_rgb( ) -> data_t
+    {
+        // JPXDecode stays encoded, its bytes are no pixels
+        if ( !stream->filters.empty( ) && stream->filters.back( ) == "JPXDecode" )
+            throw std::runtime_error( "JPXDecode images are not supported" );
+        if ( !is_jpeg( ) )
+            return color_space->convert_to_rgb( stream->decode( ), stream->dict );
+
+        // the decoder already converts to gray or RGB
+        auto params = stream->dict->get<PDFDictionary>( names::DecodeParms );
+        auto pixels = PDFDCTFilter( ).decode( stream->decode( ), params );
+        auto count = static_cast<std::size_t>( width ) * static_cast<std::size_t>( height );
+        if ( pixels.size( ) != count )
+            return pixels;
+        auto rgb = data_t( count * 3, '\0' );
+        for ( std::size_t i = 0; i < count; ++i )
+            rgb[ 3 * i ] = rgb[ 3 * i + 1 ] = rgb[ 3 * i + 2 ] = pixels[ i ];
+        return rgb;
     }
 
     auto PDFImage::as_rgba( ) -> data_t
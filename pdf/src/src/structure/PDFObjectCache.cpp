@@ -0,0 +1,241 @@
+#include "vrock/pdf/structure/PDFObjectCache.hpp"
+
+#include "vrock/pdf/structure/PDFStreams.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace vrock::pdf
+{
+    PDFObjectCache::PDFObjectCache( PDFCachePolicy policy ) : policy( policy )
+    {
+    }
+
+    auto PDFObjectCache::get( const std::shared_ptr<PDFRef> &ref ) -> std::shared_ptr<PDFBaseObject>
+    {
+        std::unique_lock lock( mutex );
+        return get_unlocked( ref );
+    }
+
+    auto PDFObjectCache::insert( const std::shared_ptr<PDFRef> &ref, std::shared_ptr<PDFBaseObject> obj, bool pin )
+        -> void
+    {
+        std::unique_lock lock( mutex );
+        insert_unlocked( ref, std::move( obj ), pin );
+    }
+
+    auto PDFObjectCache::insert_or_get( const std::shared_ptr<PDFRef> &ref, std::shared_ptr<PDFBaseObject> obj )
+        -> std::shared_ptr<PDFBaseObject>
+    {
+        std::unique_lock lock( mutex );
+        if ( auto cached = get_unlocked( ref ) )
+            return cached;
+        insert_unlocked( ref, obj, false );
+        return obj;
+    }
+
+    auto PDFObjectCache::get_unlocked( const std::shared_ptr<PDFRef> &ref ) -> std::shared_ptr<PDFBaseObject>
+    {
+        if ( auto it = entries.find( ref ); it != entries.end( ) )
+        {
+            auto &entry = it->second;
+            if ( !entry.pinned )
+                lru.splice( lru.begin( ), lru, entry.position );
+            return entry.object;
+        }
+        if ( auto it = evicted.find( ref ); it != evicted.end( ) )
+        {
+            auto obj = it->second.lock( );
+            evicted.erase( it );
+            if ( obj )
+                insert_unlocked( ref, obj, false );
+            return obj;
+        }
+        return nullptr;
+    }
+
+    auto PDFObjectCache::insert_unlocked( const std::shared_ptr<PDFRef> &ref, std::shared_ptr<PDFBaseObject> obj,
+                                          bool pin ) -> void
+    {
+        erase_unlocked( ref );
+        Entry entry;
+        entry.pinned = pin || should_pin( obj );
+        if ( !entry.pinned )
+        {
+            entry.size = estimate_size( obj );
+            lru.push_front( ref );
+            entry.position = lru.begin( );
+            current_size += entry.size;
+        }
+        entry.object = std::move( obj );
+        entries.emplace( ref, std::move( entry ) );
+        evict( );
+    }
+
+    auto PDFObjectCache::contains( const std::shared_ptr<PDFRef> &ref ) const -> bool
+    {
+        std::unique_lock lock( mutex );
+        return entries.contains( ref );
+    }
+
+    auto PDFObjectCache::erase( const std::shared_ptr<PDFRef> &ref ) -> void
+    {
+        std::unique_lock lock( mutex );
+        erase_unlocked( ref );
+    }
+
+    auto PDFObjectCache::erase_unlocked( const std::shared_ptr<PDFRef> &ref ) -> void
+    {
+        evicted.erase( ref );
+        auto it = entries.find( ref );
+        if ( it == entries.end( ) )
+            return;
+        if ( !it->second.pinned )
+        {
+            current_size -= it->second.size;
+            lru.erase( it->second.position );
+        }
+        entries.erase( it );
+    }
+
+    auto PDFObjectCache::clear( ) -> void
+    {
+        std::unique_lock lock( mutex );
+        lru.clear( );
+        entries.clear( );
+        evicted.clear( );
+        current_size = 0;
+    }
+
+    auto PDFObjectCache::for_each(
+        const std::function<void( const std::shared_ptr<PDFRef> &, const std::shared_ptr<PDFBaseObject> & )> &fn )
+        -> void
+    {
+        // fn may use the cache itself, so it is called on a snapshot
+        std::vector<std::pair<std::shared_ptr<PDFRef>, std::shared_ptr<PDFBaseObject>>> objects;
+        {
+            std::unique_lock lock( mutex );
+            objects.reserve( entries.size( ) + evicted.size( ) );
+            for ( const auto &[ ref, entry ] : entries )
+                objects.emplace_back( ref, entry.object );
+            for ( const auto &[ ref, obj ] : evicted )
+                if ( auto o = obj.lock( ) )
+                    objects.emplace_back( ref, std::move( o ) );
+        }
+        for ( const auto &[ ref, obj ] : objects )
+            fn( ref, obj );
+    }
+
+    auto PDFObjectCache::pin( const std::shared_ptr<PDFRef> &ref ) -> void
+    {
+        std::unique_lock lock( mutex );
+        auto it = entries.find( ref );
+        if ( it == entries.end( ) || it->second.pinned )
+            return;
+        current_size -= it->second.size;
+        lru.erase( it->second.position );
+        it->second.pinned = true;
+    }
+
+    auto PDFObjectCache::unpin( const std::shared_ptr<PDFRef> &ref ) -> void
+    {
+        std::unique_lock lock( mutex );
+        auto it = entries.find( ref );
+        if ( it == entries.end( ) || !it->second.pinned )
+            return;
+        auto &entry = it->second;
+        entry.pinned = false;
+        entry.size = estimate_size( entry.object );
+        lru.push_front( it->first );
+        entry.position = lru.begin( );
+        current_size += entry.size;
+        evict( );
+    }
+
+    auto PDFObjectCache::set_policy( PDFCachePolicy p ) -> void
+    {
+        std::unique_lock lock( mutex );
+        policy = p;
+        evict( );
+    }
+
+    auto PDFObjectCache::get_policy( ) const -> PDFCachePolicy
+    {
+        std::unique_lock lock( mutex );
+        return policy;
+    }
+
+    auto PDFObjectCache::size( ) const -> std::size_t
+    {
+        std::unique_lock lock( mutex );
+        return entries.size( );
+    }
+
+    auto PDFObjectCache::byte_size( ) const -> std::size_t
+    {
+        std::unique_lock lock( mutex );
+        return current_size;
+    }
+
+    auto PDFObjectCache::should_pin( const std::shared_ptr<PDFBaseObject> &obj ) const -> bool
+    {
+        if ( policy.pin_object_streams )
+            if ( auto stream = obj->to<PDFStream>( ) )
+                return stream->stream_type == PDFStreamType::Object;
+        if ( policy.pin_page_tree )
+            if ( auto dict = obj->to<PDFDictionary>( ) )
+                if ( auto type = dict->get<PDFName>( names::Type, false ) )
+                    return type->id == names::Pages || type->id == names::Page;
+        return false;
+    }
+
+    auto PDFObjectCache::evict( ) -> void
+    {
+        if ( policy.max_size == 0 )
+            return;
+        // keep the most recently inserted object even if it exceeds the limit on its own
+        while ( current_size > policy.max_size && lru.size( ) > 1 )
+        {
+            auto ref = lru.back( );
+            auto it = entries.find( ref );
+            evicted[ ref ] = it->second.object;
+            current_size -= it->second.size;
+            entries.erase( it );
+            lru.pop_back( );
+        }
+        if ( evicted.size( ) > entries.size( ) + 1024 )
+            std::erase_if( evicted, []( const auto &e ) { return e.second.expired( ); } );
+    }
+
+    auto estimate_size( const std::shared_ptr<PDFBaseObject> &obj ) -> std::size_t
+    {
+        if ( obj == nullptr )
+            return 0;
+        switch ( obj->type )
+        {
+        case PDFObjectType::Stream: {
+            auto stream = obj->as<PDFStream>( );
+            // views into the input source are not counted, the source is shared by all objects
+            return sizeof( PDFStream ) + stream->memory_size( ) + estimate_size( stream->dict );
+        }
+        case PDFObjectType::Dictionary: {
+            std::size_t size = sizeof( PDFDictionary );
+            for ( auto &[ k, v ] : obj->as<PDFDictionary>( )->dict )
+                size += sizeof( PDFName ) + k->name.size( ) + estimate_size( v );
+            return size;
+        }
+        case PDFObjectType::Array: {
+            std::size_t size = sizeof( PDFArray );
+            for ( auto &v : obj->as<PDFArray>( )->value )
+                size += estimate_size( v );
+            return size;
+        }
+        case PDFObjectType::String:
+            return sizeof( PDFTextString ) + obj->as<PDFString>( )->get_size( );
+        case PDFObjectType::Name:
+            return sizeof( PDFName ) + obj->as<PDFName>( )->name.size( );
+        default:
+            return sizeof( PDFReal );
+        }
+    }
+} // namespace vrock::pdf
\ No newline at end of file
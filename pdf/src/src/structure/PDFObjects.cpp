@@ -1,6 +1,7 @@
 #include "vrock/pdf/structure/PDFObjects.hpp"
 
 #include "vrock/pdf/structure/PDFContext.hpp"
+#include "vrock/pdf/structure/PDFEncryption.hpp"
 
 #include <sstream>
 
@@ -42,7 +43,8 @@ namespace vrock::pdf
 
     PDFName::PDFName( std::string n, bool parse ) : PDFBaseObject( PDFObjectType::Name )
     {
-        if ( parse )
+        // names without escapes are taken as they are
+        if ( parse && n.find( '#' ) != std::string::npos )
         {
             std::stringstream ss;
             for ( size_t i = 0; i < n.length( ); i++ )
@@ -59,7 +61,8 @@ namespace vrock::pdf
             name = ss.str( );
         }
         else
-            name = n;
+            name = std::move( n );
+        id = names::find( name );
     }
     bool PDFName::operator==( const PDFName &rhs ) const
     {
@@ -73,12 +76,32 @@ namespace vrock::pdf
 
     size_t PDFNamePtrHash::operator( )( const std::shared_ptr<PDFName> &n ) const
     {
-        return std::hash<std::string>( )( n->name );
+        if ( n->id != 0 )
+            return std::hash<PDFNameId>( )( n->id );
+        return std::hash<std::string_view>( )( n->name );
+    }
+
+    size_t PDFNamePtrHash::operator( )( const PDFNameKey &k ) const
+    {
+        // well-known names hash by id, so lookups by id never touch the string
+        if ( k.id != 0 )
+            return std::hash<PDFNameId>( )( k.id );
+        return std::hash<std::string_view>( )( k.name );
     }
 
     bool PDFNamePtrEqual::operator( )( const std::shared_ptr<PDFName> &l, const std::shared_ptr<PDFName> &r ) const
     {
-        return l->name == r->name;
+        return l->id == r->id && ( l->id != 0 || l->name == r->name );
+    }
+
+    bool PDFNamePtrEqual::operator( )( const PDFNameKey &l, const std::shared_ptr<PDFName> &r ) const
+    {
+        return l.id == r->id && ( l.id != 0 || l.name == r->name );
+    }
+
+    bool PDFNamePtrEqual::operator( )( const std::shared_ptr<PDFName> &l, const PDFNameKey &r ) const
+    {
+        return ( *this )( r, l );
     }
 
     PDFBool::PDFBool( bool b ) : PDFBaseObject( PDFObjectType::Bool ), value( b )
@@ -156,23 +179,76 @@ namespace vrock::pdf
     {
     }
 
+    PDFEncryptedData::PDFEncryptedData( in_data_t d, std::shared_ptr<const void> o,
+                                        std::weak_ptr<PDFBaseSecurityHandler> h, std::shared_ptr<PDFRef> r )
+        : data( d ), owner( std::move( o ) ), size( d.size( ) ), handler( std::move( h ) ), ref( std::move( r ) )
+    {
+    }
+
+    auto PDFEncryptedData::decrypt( ) -> data_t
+    {
+        auto h = handler.lock( );
+        if ( !h )
+            throw std::runtime_error( "document of the encrypted object was closed" );
+        auto decrypted = h->decrypt( data, ref );
+        // the encrypted data is not needed anymore
+        owner = nullptr;
+        data = { };
+        return decrypted;
+    }
+
+    auto PDFString::set_encrypted( data_t data, const std::shared_ptr<PDFBaseSecurityHandler> &handler,
+                                   std::shared_ptr<PDFRef> ref ) -> void
+    {
+        // the string owns its encrypted data
+        auto owner = std::make_shared<data_t>( std::move( data ) );
+        encrypted = std::make_unique<PDFEncryptedData>( *owner, owner, handler, std::move( ref ) );
+    }
+
+    auto PDFString::get_size( ) -> std::size_t
+    {
+        return encrypted && !encrypted->done.load( std::memory_order_acquire ) ? encrypted->size : value_size( );
+    }
+
+    auto PDFString::decrypt_once( ) -> void
+    {
+        std::call_once( encrypted->decrypted, [ this ] {
+            assign_decrypted( encrypted->decrypt( ) );
+            encrypted->done.store( true, std::memory_order_release );
+        } );
+    }
+
     PDFByteString::PDFByteString( in_data_t d ) : data( d )
     {
     }
 
     auto PDFByteString::get_string( ) -> std::string
     {
+        decrypt( );
         return data;
     }
 
     auto PDFByteString::get_data( ) -> data_t
     {
+        decrypt( );
         return data;
     }
 
     auto PDFByteString::set( in_data_t str ) -> void
     {
+        encrypted = nullptr;
         data = data_t( str );
+        modified = true;
+    }
+
+    auto PDFByteString::assign_decrypted( data_t d ) -> void
+    {
+        data = std::move( d );
+    }
+
+    auto PDFByteString::value_size( ) const -> std::size_t
+    {
+        return data.size( );
     }
 
     PDFTextString::PDFTextString( std::string s ) : str( std::move( s ) )
@@ -181,17 +257,31 @@ namespace vrock::pdf
 
     auto PDFTextString::get_string( ) -> std::string
     {
+        decrypt( );
         return str;
     }
 
     auto PDFTextString::get_data( ) -> data_t
     {
+        decrypt( );
         return str;
     }
 
     auto PDFTextString::set( in_data_t s ) -> void
     {
+        encrypted = nullptr;
         str = s;
+        modified = true;
+    }
+
+    auto PDFTextString::assign_decrypted( data_t d ) -> void
+    {
+        str = convert_from( d );
+    }
+
+    auto PDFTextString::value_size( ) const -> std::size_t
+    {
+        return str.size( );
     }
 
     PDFUTF8String::PDFUTF8String( const std::string &s ) : PDFTextString( convert_from( s ) )
@@ -214,22 +304,20 @@ namespace vrock::pdf
     {
     }
 
-    auto PDFDictionary::get( const std::string &k, bool resolve ) -> std::shared_ptr<PDFBaseObject>
+    auto PDFDictionary::get( PDFNameKey k, bool resolve ) -> std::shared_ptr<PDFBaseObject>
     {
-        auto key = std::make_shared<PDFName>( k );
-        if ( !dict.contains( key ) )
+        auto it = dict.find( k );
+        if ( it == dict.end( ) )
             return nullptr;
-        if ( resolve && dict[ key ]->type == PDFObjectType::IndirectObject )
-        {
-            auto ref = dict[ key ]->to<PDFRef>( );
-            return context->get_object( ref );
-        }
-        return dict[ key ];
+        if ( resolve && it->second->type == PDFObjectType::IndirectObject )
+            return context->get_object( it->second->to<PDFRef>( ) );
+        return it->second;
     }
 
     auto PDFDictionary::set( const std::string &k, std::shared_ptr<PDFBaseObject> obj ) -> void
     {
         dict[ std::make_shared<PDFName>( k ) ] = std::move( obj );
+        modified = true;
     }
 
     template <>
@@ -1,5 +1,7 @@
 #include "vrock/pdf/structure/PDFPageTree.hpp"
 
+#include <exception>
+
 namespace vrock::pdf
 {
     PageBaseObject::PageBaseObject( std::shared_ptr<PDFDictionary> dict, PageTreeNode *parent,
@@ -9,7 +11,7 @@ namespace vrock::pdf
     {
     }
 
-    auto PageBaseObject::get_property( const std::string &name ) -> std::shared_ptr<PDFBaseObject>
+    auto PageBaseObject::get_property( PDFNameKey name ) -> std::shared_ptr<PDFBaseObject>
     {
         auto obj = dictionary->get( name );
         if ( obj != nullptr )
@@ -23,23 +25,23 @@ namespace vrock::pdf
     Page::Page( std::shared_ptr<PDFDictionary> dict, std::shared_ptr<PDFContext> ctx, PageTreeNode *parent )
         : PageBaseObject( std::move( dict ), parent, ctx ), Renderable( ctx )
     {
-        auto get_box = [ this ]( const std::string &name, std::shared_ptr<Rectangle> _default ) {
+        auto get_box = [ this ]( PDFNameKey name, std::shared_ptr<Rectangle> _default ) {
             if ( auto array = get_property<PDFArray>( name ) )
                 return std::make_shared<Rectangle>( array );
             return _default;
         };
-        media_box = get_box( "MediaBox", nullptr );
-        crop_box = get_box( "CropBox", media_box );
-        bleed_box = get_box( "BleedBox", crop_box );
-        trim_box = get_box( "TrimBox", crop_box );
-        art_box = get_box( "ArtBox", crop_box );
+        media_box = get_box( names::MediaBox, nullptr );
+        crop_box = get_box( names::CropBox, media_box );
+        bleed_box = get_box( names::BleedBox, crop_box );
+        trim_box = get_box( names::TrimBox, crop_box );
+        art_box = get_box( names::ArtBox, crop_box );
 
-        if ( auto rot = get_property<PDFInteger>( "Rotate" ) )
+        if ( auto rot = get_property<PDFInteger>( names::Rotate ) )
             rotation = rot->value;
 
-        if ( auto con = dictionary->get<PDFStream>( "Contents" ) )
+        if ( auto con = dictionary->get<PDFStream>( names::Contents ) )
             content_streams.emplace_back( con );
-        else if ( auto arr = dictionary->get<PDFArray>( "Contents" ) )
+        else if ( auto arr = dictionary->get<PDFArray>( names::Contents ) )
             for ( int i = 0; i < arr->value.size( ); ++i )
                 if ( auto con = arr->get<PDFStream>( i ) )
                     content_streams.emplace_back( con );
@@ -52,19 +54,19 @@ namespace vrock::pdf
                                 PageTreeNode *parent )
         : PageBaseObject( std::move( dict ), parent, std::move( context ), false )
     {
-        if ( auto c = dictionary->get<PDFInteger>( "Count" ) )
+        if ( auto c = dictionary->get<PDFInteger>( names::Count ) )
             count = c->value;
 
-        if ( auto k = dictionary->get<PDFArray>( "Kids" ) )
+        if ( auto k = dictionary->get<PDFArray>( names::Kids ) )
         {
             kids.resize( k->value.size( ) );
             for ( int i = 0; i < k->value.size( ); ++i )
             {
                 if ( auto kid = k->get<PDFDictionary>( i ) )
                 {
-                    if ( auto type = kid->get<PDFName>( "Type" ) )
+                    if ( auto type = kid->get<PDFName>( names::Type ) )
                     {
-                        if ( type->name == "Pages" )
+                        if ( type->id == names::Pages )
                             kids[ i ] = std::make_shared<PageTreeNode>( kid, context, this );
                         // else if ( type->name == "Page" )
                         //     kids.emplace_back( std::make_shared<Page>( kid, context, this ) );
@@ -80,22 +82,8 @@ namespace vrock::pdf
         for ( std::size_t i = 0; i < kids.size( ); i++ )
         {
             if ( kids[ i ] == nullptr && idx == 0 )
-            {
-                if ( auto k = dictionary->get<PDFArray>( "Kids" ) )
-                {
-                    if ( auto kid = k->get<PDFDictionary>( i ) )
-                    {
-                        if ( auto type = kid->get<PDFName>( "Type" ) )
-                        {
-                            if ( type->name == "Page" )
-                            {
-                                kids[ i ] = std::make_shared<Page>( kid, context, this );
-                                return kids[ i ]->to<Page>( );
-                            }
-                        }
-                    }
-                }
-            }
+                if ( auto page = load_page( i ) )
+                    return page;
             if ( kids[ i ] == nullptr )
                 --idx;
 
@@ -118,10 +106,43 @@ namespace vrock::pdf
         return nullptr;
     }
 
+    auto PageTreeNode::load_page( std::size_t idx ) -> std::shared_ptr<Page>
+    {
+        if ( kids[ idx ] != nullptr )
+            return kids[ idx ]->to<Page>( );
+        if ( auto k = dictionary->get<PDFArray>( names::Kids ) )
+        {
+            if ( auto kid = k->get<PDFDictionary>( idx ) )
+            {
+                if ( auto type = kid->get<PDFName>( names::Type ) )
+                {
+                    if ( type->id == names::Page )
+                    {
+                        auto page = std::make_shared<Page>( kid, context, this );
+                        kids[ idx ] = page;
+                        return page;
+                    }
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    auto PageTreeNode::collect_leaves( std::vector<std::pair<PageTreeNode *, std::size_t>> &leaves ) -> void
+    {
+        for ( std::size_t i = 0; i < kids.size( ); i++ )
+        {
+            if ( auto node = kids[ i ]->to<PageTreeNode>( ) )
+                node->collect_leaves( leaves );
+            else
+                leaves.emplace_back( this, i );
+        }
+    }
+
     PDFPageTree::PDFPageTree( std::shared_ptr<PDFDictionary> dict, std::shared_ptr<PDFContext> ctx )
         : context( std::move( ctx ) )
     {
-        if ( auto c = dict->get<PDFInteger>( "Count" ) )
+        if ( auto c = dict->get<PDFInteger>( names::Count ) )
             pages_count = c->value;
         pages.resize( pages_count );
         page_tree = std::make_shared<PageTreeNode>( dict, context, nullptr );
@@ -150,6 +171,75 @@ namespace vrock::pdf
         return pages;
     }
 
+    auto PDFPageTree::get_pages_parallel( utils::ThreadPool &pool ) -> utils::List<std::shared_ptr<Page>>
+    {
+        if ( all_pages_parsed )
+            return pages;
+
+        // the tree nodes are already loaded, only the pages themselves are loaded concurrently
+        std::vector<std::pair<PageTreeNode *, std::size_t>> leaves;
+        page_tree->collect_leaves( leaves );
+
+        std::vector<std::pair<std::size_t, std::future<std::shared_ptr<Page>>>> futures;
+        for ( std::size_t i = 0; i < leaves.size( ) && i < pages.size( ); ++i )
+            if ( pages[ i ] == nullptr )
+                futures.emplace_back(
+                    i, pool.submit( [ leaf = leaves[ i ] ]( ) { return leaf.first->load_page( leaf.second ); } ) );
+        // every task has to finish before an error is reported, they work on the page tree
+        std::exception_ptr error;
+        for ( auto &[ i, future ] : futures )
+        {
+            try
+            {
+                pages[ i ] = future.get( );
+            }
+            catch ( ... )
+            {
+                if ( !error )
+                    error = std::current_exception( );
+            }
+        }
+        if ( error )
+            std::rethrow_exception( error );
+
+        all_pages_parsed = true;
+        return pages;
+    }
+
+    auto PDFPageTree::extract_text_parallel( utils::ThreadPool &pool )
+        -> std::vector<utils::List<std::shared_ptr<Text>>>
+    {
+        get_pages_parallel( pool );
+
+        std::vector<std::future<utils::List<std::shared_ptr<Text>>>> futures;
+        futures.reserve( pages.size( ) );
+        for ( auto &page : pages )
+            futures.emplace_back( pool.submit( [ page ]( ) {
+                if ( page == nullptr )
+                    return utils::List<std::shared_ptr<Text>>( );
+                return page->get_text( );
+            } ) );
+
+        std::vector<utils::List<std::shared_ptr<Text>>> text;
+        text.reserve( futures.size( ) );
+        std::exception_ptr error;
+        for ( auto &future : futures )
+        {
+            try
+            {
+                text.emplace_back( future.get( ) );
+            }
+            catch ( ... )
+            {
+                if ( !error )
+                    error = std::current_exception( );
+            }
+        }
+        if ( error )
+            std::rethrow_exception( error );
+        return text;
+    }
+
     auto PDFPageTree::get_page_count( ) -> std::int32_t
     {
         return pages_count;
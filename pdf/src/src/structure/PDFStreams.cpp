@@ -3,21 +3,38 @@
 
 #include "vrock/pdf/structure/PDFFilters.hpp"
 
-#include <iomanip>
-
-#include <vrock/utils/SpanHelpers.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 
 namespace vrock::pdf
 {
-    PDFStream::PDFStream( std::shared_ptr<PDFDictionary> dictionary, in_data_t _data, PDFStreamType t )
-        : PDFBaseObject( PDFObjectType::Stream ), stream_type( t ), dict( std::move( dictionary ) )
+    PDFStream::PDFStream( std::shared_ptr<PDFDictionary> dictionary, in_data_t _data, PDFStreamType t,
+                          std::shared_ptr<const void> o )
+        : PDFBaseObject( PDFObjectType::Stream ), stream_type( t ), dict( std::move( dictionary ) ),
+          encoded( _data ), owner( std::move( o ) )
     {
-        // get filters and param dictionary
-        auto filter = dict->get( "Filter" );
-        auto p = dict->get( "DecodeParms" );
-        auto param = std::make_shared<PDFDictionary>( );
-        if ( p->is( PDFObjectType::Dictionary ) )
-            param = p->as<PDFDictionary>( );
+        if ( !owner )
+        {
+            storage = data_t( _data );
+            encoded = storage;
+        }
+        read_filters( );
+    }
+
+    PDFStream::PDFStream( std::shared_ptr<PDFDictionary> dictionary, in_data_t encrypted_data,
+                          std::shared_ptr<const void> owner, const std::shared_ptr<PDFBaseSecurityHandler> &handler,
+                          std::shared_ptr<PDFRef> ref )
+        : PDFBaseObject( PDFObjectType::Stream ), stream_type( PDFStreamType::Raw ), dict( std::move( dictionary ) ),
+          encrypted(
+              std::make_unique<PDFEncryptedData>( encrypted_data, std::move( owner ), handler, std::move( ref ) ) )
+    {
+        read_filters( );
+    }
+
+    auto PDFStream::read_filters( ) -> void
+    {
+        auto filter = dict->get( names::Filter );
         if ( auto name = filter->to<PDFName>( ) )
             filters.emplace_back( name->name );
         else if ( auto arr = filter->to<PDFArray>( ) )
@@ -26,24 +43,114 @@ namespace vrock::pdf
                 if ( auto name = item->to<PDFName>( ) )
                     filters.emplace_back( name->name );
         }
+    }
+
+    auto PDFStream::raw( ) -> in_data_t
+    {
+        if ( encrypted )
+            std::call_once( encrypted->decrypted, [ this ] {
+                storage = encrypted->decrypt( );
+                encoded = storage;
+            } );
+        return encoded;
+    }
+
+    auto PDFStream::decode( ) -> data_t
+    {
+        {
+            std::unique_lock lock( mutex );
+            if ( cached )
+                return data;
+        }
+        return run_filters( );
+    }
+
+    auto PDFStream::run_filters( ) -> data_t
+    {
+        auto p = dict->get( names::DecodeParms );
+        auto param = std::make_shared<PDFDictionary>( );
+        if ( p->is( PDFObjectType::Dictionary ) )
+            param = p->as<PDFDictionary>( );
 
-        // apply filters on data and save data
-        data_t d = std::string( _data );
+        // apply filters on the encoded data. the first filter decodes straight from the input view and the last one
+        // gets the decoded length as a hint. images stay encoded until their pixels are needed
+        auto input = raw( );
+        auto end = filters.size( );
+        if ( is_image( ) )
+            --end;
+        std::size_t decoded_length = 0;
+        if ( auto dl = dict->get<PDFInteger>( names::DL ); dl && dl->value > 0 && end == filters.size( ) )
+            decoded_length = dl->value;
+        data_t out;
+        auto decoded = false;
+        for ( std::size_t i = 0; i < end; ++i )
+            if ( auto encoding = encodings.find( filters[ i ] ); encoding != encodings.end( ) )
+            {
+                auto hint = i + 1 == end ? decoded_length : 0;
+                out = encoding->second->decode( decoded ? in_data_t( out ) : input, param, hint );
+                decoded = true;
+            }
+        if ( !decoded )
+            return data_t( input );
+        return out;
+    }
 
-        for ( auto &f : filters )
-            if ( encodings.contains( f ) )
-                d = encodings[ f ]->decode( d, param );
-        data = d;
+    auto PDFStream::decoded( ) -> const data_t &
+    {
+        // concurrent callers wait for the first one instead of decoding the stream again
+        std::unique_lock lock( mutex );
+        if ( !cached )
+        {
+            data = run_filters( );
+            cached = true;
+        }
+        return data;
+    }
+
+    auto PDFStream::release( ) -> void
+    {
+        std::unique_lock lock( mutex );
+        cached = false;
+        data = { };
+    }
+
+    auto PDFStream::get_size( ) const -> std::size_t
+    {
+        std::unique_lock lock( mutex );
+        if ( cached )
+            return data.size( );
+        return encrypted ? encrypted->size : encoded.size( );
     }
 
-    PDFObjectStream::PDFObjectStream( std::shared_ptr<PDFDictionary> d, in_data_t data,
-                                      std::shared_ptr<PDFContext> ctx )
-        : PDFStream( std::move( d ), data, PDFStreamType::Object ), context( std::move( ctx ) )
+    auto PDFStream::memory_size( ) const -> std::size_t
     {
-        parser = std::make_shared<PDFObjectParser>( data_t( this->data ) );
+        std::unique_lock lock( mutex );
+        return ( cached ? data.size( ) : 0 ) + storage.size( );
+    }
+
+    auto PDFStream::is_image( ) const -> bool
+    {
+        return !filters.empty( ) && ( filters.back( ) == "DCTDecode" || filters.back( ) == "JPXDecode" );
+    }
+
+    auto PDFStream::is_decoded( ) const -> bool
+    {
+        return std::ranges::all_of( filters, []( const std::string &filter ) {
+            return filter == "FlateDecode" || filter == "ASCIIHexDecode";
+        } );
+    }
+
+    PDFObjectStream::PDFObjectStream( std::shared_ptr<PDFDictionary> d, in_data_t data, std::shared_ptr<PDFContext> ctx,
+                                      std::shared_ptr<const void> owner )
+        : PDFStream( std::move( d ), data, PDFStreamType::Object, std::move( owner ) ), context( std::move( ctx ) )
+    {
+        // the parser owns the decoded data, so it is not affected by release
+        auto content = std::make_shared<StringInputSource>( decode( ) );
+        content_size = content->view( ).size( );
+        parser = std::make_shared<PDFObjectParser>( content );
         parser->set_context( context );
-        auto n = dict->get<PDFInteger>( "N" );
-        auto f = dict->get<PDFInteger>( "First" );
+        auto n = dict->get<PDFInteger>( names::N );
+        auto f = dict->get<PDFInteger>( names::First );
         if ( !( n && f ) )
             throw std::runtime_error( "missing entries N and First in Object stream Dictionary" );
         first = f->value;
@@ -54,35 +161,104 @@ namespace vrock::pdf
         }
     }
 
+    auto PDFObjectStream::memory_size( ) const -> std::size_t
+    {
+        return PDFStream::memory_size( ) + content_size;
+    }
+
     auto PDFObjectStream::get_object( std::size_t idx ) -> std::shared_ptr<PDFBaseObject>
     {
         auto p = offsets[ idx ];
         auto ref = std::make_shared<PDFRef>( p.first, 0, 1 );
-        if ( objects.find( ref ) != objects.end( ) )
-            return objects[ ref ];
+        // resolved objects are cached by the context
+        std::unique_lock lock( parser_mutex );
         parser->_offset = p.second + first;
-        objects[ ref ] = parser->parse_object( ref, false );
-        return objects[ ref ];
+        return parser->parse_object( ref, false );
     }
 
-    auto PDFXRefStream::get_entries( ) -> std::unordered_map<std::shared_ptr<XRefEntry>, std::shared_ptr<XRefEntry>,
-                                                             XRefEntryPtrHash, XRefEntryPtrEqual>
+    namespace
     {
-        if ( auto size = dict->get<PDFInteger>( "Size" ) )
+        // reads a big-endian integer of width bytes, a width of 0 yields the default value
+        template <std::size_t Width>
+        inline auto read_field( const std::uint8_t *p, std::uint64_t def ) -> std::uint64_t
+        {
+            if constexpr ( Width == 0 )
+                return def;
+            std::uint64_t value = 0;
+            for ( std::size_t i = 0; i < Width; ++i )
+                value = ( value << 8 ) | p[ i ];
+            return value;
+        }
+
+        inline auto read_field( const std::uint8_t *p, std::size_t width, std::uint64_t def ) -> std::uint64_t
         {
-            if ( auto w = dict->get<PDFArray>( "W" ) )
+            if ( width == 0 )
+                return def;
+            std::uint64_t value = 0;
+            for ( std::size_t i = 0; i < width; ++i )
+                value = ( value << 8 ) | p[ i ];
+            return value;
+        }
+
+        // the entries store 32 bit offsets and generation numbers, wider values cannot be represented
+        inline auto narrow_field( std::uint64_t value ) -> std::uint32_t
+        {
+            if ( value > std::numeric_limits<std::uint32_t>::max( ) )
+                throw std::runtime_error( "XRefStream entry out of range" );
+            return static_cast<std::uint32_t>( value );
+        }
+
+        // every type above 2 is unknown, so larger values are saturated instead of wrapping into a known type
+        inline auto narrow_type( std::uint64_t value ) -> std::uint8_t
+        {
+            return static_cast<std::uint8_t>( std::min<std::uint64_t>( value, 0xFF ) );
+        }
+
+        // the widths of the common layouts are known at compile time, so the field reads are unrolled
+        template <std::size_t W0, std::size_t W1, std::size_t W2>
+        auto decode_rows( const std::uint8_t *p, std::uint32_t start, std::uint32_t count,
+                          std::vector<XRefEntry> &entries ) -> void
+        {
+            for ( std::uint32_t j = 0; j < count; ++j, p += W0 + W1 + W2 )
+                entries.emplace_back( narrow_field( read_field<W1>( p + W0, 0 ) ), start + j,
+                                      narrow_field( read_field<W2>( p + W0 + W1, 0 ) ),
+                                      narrow_type( read_field<W0>( p, 1 ) ) );
+        }
+
+        auto decode_rows( const std::uint8_t *p, const std::size_t ( &w )[ 3 ], std::uint32_t start,
+                          std::uint32_t count, std::vector<XRefEntry> &entries ) -> void
+        {
+            if ( w[ 0 ] == 1 && w[ 1 ] == 2 && w[ 2 ] == 1 )
+                return decode_rows<1, 2, 1>( p, start, count, entries );
+            if ( w[ 0 ] == 1 && w[ 1 ] == 3 && w[ 2 ] == 1 )
+                return decode_rows<1, 3, 1>( p, start, count, entries );
+            if ( w[ 0 ] == 1 && w[ 1 ] == 4 && w[ 2 ] == 2 )
+                return decode_rows<1, 4, 2>( p, start, count, entries );
+            for ( std::uint32_t j = 0; j < count; ++j, p += w[ 0 ] + w[ 1 ] + w[ 2 ] )
+                entries.emplace_back( narrow_field( read_field( p + w[ 0 ], w[ 1 ], 0 ) ), start + j,
+                                      narrow_field( read_field( p + w[ 0 ] + w[ 1 ], w[ 2 ], 0 ) ),
+                                      narrow_type( read_field( p, w[ 0 ], 1 ) ) );
+        }
+    } // namespace
+
+    auto PDFXRefStream::get_entries( ) -> std::vector<XRefEntry>
+    {
+        const auto &data = decoded( );
+        if ( auto size = dict->get<PDFInteger>( names::Size ) )
+        {
+            if ( auto w = dict->get<PDFArray>( names::W ) )
             {
                 // Get field size
                 std::size_t field_size[ 3 ];
                 for ( int i = 0; i < 3; ++i )
-                    if ( auto num = w->get<PDFInteger>( i ) )
+                    if ( auto num = w->get<PDFInteger>( i ); num && num->value >= 0 && num->value <= 8 )
                         field_size[ i ] = num->value;
                     else
                         throw std::runtime_error( "W entry of XRefStream incorrect" );
 
                 // Get Indexes of subsections
                 std::vector<std::int32_t> index = { 0, size->value };
-                if ( auto indexes = dict->get<PDFArray>( "Index" ) )
+                if ( auto indexes = dict->get<PDFArray>( names::Index ) )
                 {
                     index.clear( );
                     index.reserve( indexes->value.size( ) );
@@ -91,43 +267,27 @@ namespace vrock::pdf
                             index.emplace_back( num->value );
                 }
 
-                // Parse entries
-                std::unordered_map<std::shared_ptr<XRefEntry>, std::shared_ptr<XRefEntry>, XRefEntryPtrHash,
-                                   XRefEntryPtrEqual>
-                    entries = { };
-
-                std::size_t offset = 0;
+                // every row has to be present in the data before anything is decoded
                 std::size_t row_length = field_size[ 0 ] + field_size[ 1 ] + field_size[ 2 ];
+                std::size_t rows = 0;
+                for ( std::size_t i = 0; i + 1 < index.size( ); i += 2 )
+                {
+                    if ( index[ i ] < 0 || index[ i + 1 ] < 0 )
+                        throw std::runtime_error( "Index entry of XRefStream incorrect" );
+                    rows += index[ i + 1 ];
+                }
+                if ( rows * row_length > data.size( ) )
+                    throw std::runtime_error( "XRefStream data is shorter than its Index" );
+
+                // Parse entries
+                std::vector<XRefEntry> entries = { };
+                entries.reserve( rows );
 
-                for ( std::size_t i = 0; i < index.size( ); i += 2 )
+                auto p = reinterpret_cast<const std::uint8_t *>( data.data( ) );
+                for ( std::size_t i = 0; i + 1 < index.size( ); i += 2 )
                 {
-                    auto start = index[ i ];
-                    for ( auto j = 0; j < index[ i + 1 ]; ++j )
-                    {
-                        // read field 1
-                        unsigned long field_1 = 0;
-                        if ( field_size[ 0 ] != 0 )
-                        {
-                            auto d = utils::to_hex_string( data.substr( offset, field_size[ 0 ] ) );
-                            field_1 = std::stoul( d, nullptr, 16 );
-                        }
-                        else
-                            field_1 = 1;
-
-                        // read field 2
-                        auto d = utils::to_hex_string( data.substr( offset + field_size[ 0 ], field_size[ 1 ] ) );
-                        auto field_2 = std::stoul( d, nullptr, 16 );
-
-                        // read field 3
-                        d = utils::to_hex_string(
-                            data.substr( offset + field_size[ 0 ] + field_size[ 1 ], field_size[ 2 ] ) );
-                        auto field_3 = std::stoul( d, nullptr, 16 );
-
-                        auto e = std::make_shared<XRefEntry>( field_2, start + j, field_3, field_1 );
-                        entries[ e ] = e;
-
-                        offset += row_length;
-                    }
+                    decode_rows( p, field_size, index[ i ], index[ i + 1 ], entries );
+                    p += index[ i + 1 ] * row_length;
                 }
                 return entries;
             }
@@ -138,8 +298,8 @@ namespace vrock::pdf
             throw std::runtime_error( "Size not found in XRefStream Dictionary or it is not an Integer" );
     }
 
-    PDFXRefStream::PDFXRefStream( std::shared_ptr<PDFDictionary> d, in_data_t data )
-        : PDFStream( std::move( d ), data, PDFStreamType::XRef )
+    PDFXRefStream::PDFXRefStream( std::shared_ptr<PDFDictionary> d, in_data_t data, std::shared_ptr<const void> owner )
+        : PDFStream( std::move( d ), data, PDFStreamType::XRef, std::move( owner ) )
     {
     }
 
@@ -29,15 +29,15 @@ namespace vrock::pdf
     ResourceDictionary::ResourceDictionary( std::shared_ptr<PDFDictionary> dict_, std::shared_ptr<PDFContext> ctx )
         : dict( std::move( dict_ ) ), context( std::move( ctx ) )
     {
-        if ( auto ext_g_states = dict->get<PDFDictionary>( "ExtGState" ) )
+        if ( auto ext_g_states = dict->get<PDFDictionary>( names::ExtGState ) )
             for ( auto [ k, v ] : ext_g_states->dict )
                 if ( auto val = ext_g_states->get<PDFDictionary>( k->name ) ) // to avoid getting PDFRef
                     ext_g_state[ k->name ] = val;
 
-        if ( auto xobject = dict->get<PDFDictionary>( "XObject" ) )
+        if ( auto xobject = dict->get<PDFDictionary>( names::XObject ) )
             load_xobject( xobject );
 
-        if ( auto font = dict->get<PDFDictionary>( "Font" ) )
+        if ( auto font = dict->get<PDFDictionary>( names::Font ) )
         {
             for ( auto [ k, v ] : font->dict )
             {
@@ -61,7 +61,7 @@ namespace vrock::pdf
                 {
                     std::string type;
                     if ( auto stm = val->to<PDFStream>( ) )
-                        if ( auto t = stm->dict->get<PDFName>( "Subtype" ) )
+                        if ( auto t = stm->dict->get<PDFName>( names::Subtype ) )
                             type = t->name;
                     std::cout << type << std::endl;
                     switch ( type.size( ) )
@@ -79,8 +79,9 @@ namespace vrock::pdf
             }
         }
 
-        if ( !dict->has( "XObject" ) )
-            dict->set( "XObject", xobjects );
+        // filling in the default is not a modification of the document
+        if ( !dict->has( names::XObject ) )
+            dict->dict[ std::make_shared<PDFName>( "XObject" ) ] = xobjects;
     }
 
     template <>
@@ -111,6 +112,25 @@ namespace vrock::pdf
         return text;
     }
 
+    auto Renderable::get_text( std::size_t max_characters ) -> utils::List<std::shared_ptr<Text>>
+    {
+        auto interpreter = ContentStreamParser( resources, context );
+        std::size_t characters = 0, counted = 0;
+        interpreter.interpret( content_streams, [ & ] {
+            for ( ; counted < interpreter.text.size( ); counted++ )
+                characters += interpreter.text[ counted ]->text.length( );
+            return characters >= max_characters;
+        } );
+        return std::move( interpreter.text );
+    }
+
+    auto Renderable::get_program( ) -> std::shared_ptr<ContentProgram>
+    {
+        if ( !program )
+            program = compile_content( content_streams, context );
+        return program;
+    }
+
     auto Renderable::parse_content( ) -> void
     {
         if ( parsed )
@@ -120,11 +140,9 @@ namespace vrock::pdf
             parsed = true;
             return;
         }
-        std::string content;
-        for ( auto &content_stream : content_streams )
-            content += content_stream->data;
-
-        auto parser = ContentStreamParser( content, resources, context );
+        // the streams are compiled once, so interpreting them again does not lex them again
+        auto parser = ContentStreamParser( resources, context );
+        parser.execute( *get_program( ) );
         images = std::move( parser.images );
         text = std::move( parser.text );
         parsed = true;
@@ -132,10 +150,10 @@ namespace vrock::pdf
 
     Form::Form( std::shared_ptr<PDFStream> form, std::shared_ptr<PDFContext> ctx ) : Renderable( std::move( ctx ) )
     {
-        if ( auto array = form->dict->get<PDFArray>( "BBox" ) )
+        if ( auto array = form->dict->get<PDFArray>( names::BBox ) )
             bbox = std::make_shared<Rectangle>( array );
         content_streams.push_back( form );
-        if ( auto res = form->dict->get<PDFDictionary>( "Resources" ) )
+        if ( auto res = form->dict->get<PDFDictionary>( names::Resources ) )
             resources = std::make_shared<ResourceDictionary>( res, context );
     }
 } // namespace vrock::pdf
\ No newline at end of file
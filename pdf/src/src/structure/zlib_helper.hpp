@@ -1,8 +1,17 @@
 #pragma once
 
 #include <vrock/utils/ByteArray.hpp>
+#include <vrock/utils/ThreadPool.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
 #include <cstring>
+#include <exception>
+#include <functional>
+#include <future>
+#include <vector>
 #include <zlib.h>
 
 #include <vrock/utils/SpanHelpers.hpp>
@@ -10,40 +19,312 @@
 namespace vrock::pdf
 {
     constexpr std::size_t buffer_size = 16384;
+    // upper bound of the deflate compression ratio, used to sanity check size hints
+    constexpr std::size_t max_deflate_ratio = 1032;
     thread_local inline auto buffer = data_t( buffer_size, '\0' );
 
-    auto inflate( in_data_t data, std::size_t new_buffer_size = 16384 ) -> data_t
+    inline auto init_inflate( z_stream &zs, in_data_t data ) -> void
     {
-        std::vector<data_t> chunks = { };
-        z_stream zs;
         std::memset( &zs, 0, sizeof( zs ) );
         if ( inflateInit( &zs ) != Z_OK )
             throw std::runtime_error( "stream decompression failed" );
         zs.next_in = (Bytef *)data.data( );
         zs.avail_in = data.size( );
+    }
+
+    inline auto end_inflate( z_stream &zs, int ret ) -> void
+    {
+        inflateEnd( &zs );
+        if ( ret != Z_STREAM_END )
+            throw std::runtime_error( zs.msg ? zs.msg : "stream decompression failed" );
+    }
+
+    /**
+     * @brief resizes out without initializing the new bytes, they are overwritten by the caller
+     */
+    inline auto grow_uninitialized( data_t &out, std::size_t size ) -> void
+    {
+        out.resize_and_overwrite( size, []( char *, std::size_t n ) { return n; } );
+    }
+
+    /**
+     * @brief inflates data into a single buffer which grows geometrically
+     * @param size_hint expected decoded size, e.g. from the /DL entry of the stream
+     */
+    inline auto inflate( in_data_t data, std::size_t size_hint = 0 ) -> data_t
+    {
+        z_stream zs;
+        init_inflate( zs, data );
 
-        zs.next_out = (Bytef *)buffer.data( );
-        zs.avail_out = buffer_size;
-        int ret = inflate( &zs, 0 );
-        if ( ret != Z_OK )
+        auto size = std::max( data.size( ) * 4, buffer_size );
+        if ( size_hint != 0 )
+            size = std::min( size_hint, data.size( ) * max_deflate_ratio + buffer_size );
+        data_t out;
+        grow_uninitialized( out, size );
+        int ret;
+        do
         {
-            inflateEnd( &zs );
-            if ( ret != Z_STREAM_END )
-                throw std::runtime_error( zs.msg );
-            return buffer.substr( 0, zs.total_out );
+            if ( zs.total_out == out.size( ) )
+                grow_uninitialized( out, out.size( ) * 2 );
+            zs.next_out = (Bytef *)out.data( ) + zs.total_out;
+            zs.avail_out = (uInt)std::min<std::size_t>( out.size( ) - zs.total_out, UINT_MAX );
+            ret = ::inflate( &zs, Z_NO_FLUSH );
+        } while ( ret == Z_OK );
+        end_inflate( zs, ret );
+        out.resize( zs.total_out );
+        // decoded streams are cached, so a mostly unused buffer is given back
+        if ( out.capacity( ) - out.size( ) > out.size( ) / 4 + buffer_size )
+            out.shrink_to_fit( );
+        return out;
+    }
+
+    // size of the blocks compressed independently by deflate_parallel
+    constexpr std::size_t parallel_deflate_block = 128 * 1024;
+    // deflate window, the tail of the previous block used as dictionary for the next one
+    constexpr std::size_t deflate_window = 32 * 1024;
+
+    /**
+     * @brief compresses data into a zlib stream by compressing blocks on the pool and the calling thread. every block
+     * is primed with the last 32 KiB of its predecessor and ends on a byte boundary, so the raw deflate blocks are
+     * concatenated into a single stream that only compresses slightly worse than a serial one.
+     * @param level zlib compression level from 0 to 9, -1 selects the default level
+     */
+    inline auto deflate_parallel( in_data_t data, utils::ThreadPool &pool, int level = Z_DEFAULT_COMPRESSION )
+        -> data_t
+    {
+        auto blocks =
+            std::max<std::size_t>( 1, ( data.size( ) + parallel_deflate_block - 1 ) / parallel_deflate_block );
+        auto compressed = std::vector<data_t>( blocks );
+        auto checksums = std::vector<uLong>( blocks );
+        auto failed = std::atomic_bool( false );
+
+        auto compress = [ & ]( std::size_t block ) {
+            auto start = block * parallel_deflate_block;
+            auto input = data.substr( start, parallel_deflate_block );
+            checksums[ block ] = adler32( adler32( 0, nullptr, 0 ), (const Bytef *)input.data( ), (uInt)input.size( ) );
+
+            z_stream zs;
+            std::memset( &zs, 0, sizeof( zs ) );
+            // raw deflate, the zlib header and checksum are written once for the whole stream
+            if ( deflateInit2( &zs, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+            {
+                failed = true;
+                return;
+            }
+            if ( start != 0 )
+            {
+                auto window = std::min( start, deflate_window );
+                auto dictionary = data.substr( start - window, window );
+                deflateSetDictionary( &zs, (const Bytef *)dictionary.data( ), (uInt)dictionary.size( ) );
+            }
+            auto &out = compressed[ block ];
+            // the bound does not include the empty stored block ending a sync flush
+            out.resize( deflateBound( &zs, (uLong)input.size( ) ) + 16 );
+            zs.next_in = (Bytef *)input.data( );
+            zs.avail_in = (uInt)input.size( );
+            zs.next_out = (Bytef *)out.data( );
+            zs.avail_out = (uInt)out.size( );
+            auto last = block + 1 == blocks;
+            auto ret = ::deflate( &zs, last ? Z_FINISH : Z_SYNC_FLUSH );
+            if ( ret != ( last ? Z_STREAM_END : Z_OK ) || zs.avail_in != 0 )
+                failed = true;
+            out.resize( zs.total_out );
+            deflateEnd( &zs );
+        };
+        {
+            auto threads = std::min<std::size_t>( pool.size( ) + 1, blocks );
+            auto compress_every = [ &, threads ]( std::size_t first ) {
+                for ( auto block = first; block < blocks; block += threads )
+                    compress( block );
+            };
+            std::vector<std::future<void>> futures;
+            futures.reserve( threads - 1 );
+            for ( std::size_t t = 1; t < threads; ++t )
+                futures.push_back( pool.submit( compress_every, t ) );
+            std::exception_ptr error;
+            try
+            {
+                compress_every( 0 );
+            }
+            catch ( ... )
+            {
+                error = std::current_exception( );
+            }
+            // every task has to finish before an error is reported, they reference the blocks
+            for ( auto &future : futures )
+            {
+                try
+                {
+                    future.get( );
+                }
+                catch ( ... )
+                {
+                    if ( !error )
+                        error = std::current_exception( );
+                }
+            }
+            if ( error )
+                std::rethrow_exception( error );
         }
-        chunks.push_back( buffer );
+        if ( failed )
+            throw std::runtime_error( "stream compression failed" );
+
+        // zlib header: deflate with a 32 KiB window, the level hint and a check value making it a multiple of 31
+        int hint = level < 0 ? 2 : level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+        unsigned header = 0x7800u | ( static_cast<unsigned>( hint ) << 6 );
+        header += 31 - header % 31;
+        data_t out;
+        std::size_t size = 6;
+        for ( const auto &block : compressed )
+            size += block.size( );
+        out.reserve( size );
+        out += static_cast<char>( header >> 8 );
+        out += static_cast<char>( header & 0xFF );
+
+        auto checksum = adler32( 0, nullptr, 0 );
+        for ( std::size_t block = 0; block < blocks; ++block )
+        {
+            out += compressed[ block ];
+            auto length = std::min( parallel_deflate_block, data.size( ) - block * parallel_deflate_block );
+            checksum = adler32_combine( checksum, checksums[ block ], (z_off_t)length );
+        }
+        for ( int shift = 24; shift >= 0; shift -= 8 )
+            out += static_cast<char>( checksum >> shift );
+        return out;
+    }
+
+    /**
+     * @brief compresses data into a zlib stream
+     * @param level zlib compression level from 0 to 9, -1 selects the default level
+     * @param pool data of at least parallel_threshold bytes is compressed with deflate_parallel on this pool
+     */
+    inline auto deflate( in_data_t data, int level = Z_DEFAULT_COMPRESSION, utils::ThreadPool *pool = nullptr,
+                         std::size_t parallel_threshold = SIZE_MAX ) -> data_t
+    {
+        if ( pool && data.size( ) >= parallel_threshold )
+            return deflate_parallel( data, *pool, level );
+
+        z_stream zs;
+        std::memset( &zs, 0, sizeof( zs ) );
+        if ( deflateInit( &zs, level ) != Z_OK )
+            throw std::runtime_error( "stream compression failed" );
+
+        data_t out;
+        grow_uninitialized( out, deflateBound( &zs, (uLong)data.size( ) ) );
+        // avail_in and avail_out are 32 bit, so larger buffers are passed in chunks
+        std::size_t consumed = 0, produced = 0;
+        int ret;
         do
         {
-            auto chunk = data_t( new_buffer_size, '\0' );
-            zs.next_out = (Bytef *)chunk.data( );
-            zs.avail_out = new_buffer_size;
-            ret = inflate( &zs, 0 );
-            chunks.push_back( chunk );
+            if ( zs.avail_in == 0 )
+            {
+                auto chunk = std::min<std::size_t>( data.size( ) - consumed, UINT_MAX );
+                zs.next_in = (Bytef *)data.data( ) + consumed;
+                zs.avail_in = (uInt)chunk;
+                consumed += chunk;
+            }
+            if ( produced == out.size( ) )
+                grow_uninitialized( out, out.size( ) + out.size( ) / 2 + buffer_size );
+            zs.next_out = (Bytef *)out.data( ) + produced;
+            zs.avail_out = (uInt)std::min<std::size_t>( out.size( ) - produced, UINT_MAX );
+            auto available = zs.avail_out;
+            ret = ::deflate( &zs, consumed == data.size( ) ? Z_FINISH : Z_NO_FLUSH );
+            produced += available - zs.avail_out;
         } while ( ret == Z_OK );
-        inflateEnd( &zs );
+        deflateEnd( &zs );
         if ( ret != Z_STREAM_END )
-            throw std::runtime_error( zs.msg );
-        return utils::combine_strings( chunks, zs.total_out );
+            throw std::runtime_error( zs.msg ? zs.msg : "stream compression failed" );
+        out.resize( produced );
+        return out;
+    }
+
+    /**
+     * @brief compresses data that is passed in multiple chunks into a single zlib stream
+     */
+    class DeflateStream
+    {
+    public:
+        explicit DeflateStream( int level = Z_DEFAULT_COMPRESSION )
+        {
+            std::memset( &zs, 0, sizeof( zs ) );
+            if ( deflateInit( &zs, level ) != Z_OK )
+                throw std::runtime_error( "stream compression failed" );
+        }
+
+        ~DeflateStream( )
+        {
+            deflateEnd( &zs );
+        }
+
+        DeflateStream( const DeflateStream & ) = delete;
+        auto operator=( const DeflateStream & ) -> DeflateStream & = delete;
+
+        /**
+         * @brief compresses data and appends the compressed bytes that are ready to out
+         */
+        auto write( in_data_t data, data_t &out ) -> void
+        {
+            run( data, Z_NO_FLUSH, out );
+        }
+
+        /**
+         * @brief appends the rest of the compressed stream to out
+         */
+        auto finish( data_t &out ) -> void
+        {
+            run( { }, Z_FINISH, out );
+        }
+
+    private:
+        auto run( in_data_t data, int flush, data_t &out ) -> void
+        {
+            zs.next_in = (Bytef *)data.data( );
+            zs.avail_in = (uInt)data.size( );
+            do
+            {
+                auto size = out.size( );
+                out.resize( size + buffer_size );
+                zs.next_out = (Bytef *)out.data( ) + size;
+                zs.avail_out = buffer_size;
+                auto ret = ::deflate( &zs, flush );
+                out.resize( size + buffer_size - zs.avail_out );
+                if ( ret == Z_STREAM_ERROR )
+                    throw std::runtime_error( zs.msg ? zs.msg : "stream compression failed" );
+            } while ( zs.avail_out == 0 );
+        }
+
+        z_stream zs;
+    };
+
+    /**
+     * @brief inflates data and passes it to consumer in chunks of at most buffer_size bytes
+     * @return number of decoded bytes
+     */
+    inline auto inflate( in_data_t data, const std::function<void( in_data_t )> &consumer ) -> std::size_t
+    {
+        z_stream zs;
+        init_inflate( zs, data );
+
+        int ret;
+        do
+        {
+            zs.next_out = (Bytef *)buffer.data( );
+            zs.avail_out = buffer_size;
+            ret = ::inflate( &zs, Z_NO_FLUSH );
+            if ( ( ret == Z_OK || ret == Z_STREAM_END ) && zs.avail_out != buffer_size )
+            {
+                try
+                {
+                    consumer( in_data_t( buffer.data( ), buffer_size - zs.avail_out ) );
+                }
+                catch ( ... )
+                {
+                    inflateEnd( &zs );
+                    throw;
+                }
+            }
+        } while ( ret == Z_OK );
+        end_inflate( zs, ret );
+        return zs.total_out;
     }
 } // namespace vrock::pdf
\ No newline at end of file
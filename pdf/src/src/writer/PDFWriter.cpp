@@ -0,0 +1,642 @@
+#include "vrock/pdf/writer/PDFWriter.hpp"
+
+#include "vrock/pdf/structure/PDFFilters.hpp"
+
+#include "../structure/zlib_helper.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace vrock::pdf
+{
+    namespace
+    {
+        constexpr char hex_digits[] = "0123456789ABCDEF";
+
+        auto append_number( data_t &o, std::int64_t value ) -> void
+        {
+            char buf[ 24 ];
+            auto res = std::to_chars( buf, buf + sizeof( buf ), value );
+            o.append( buf, res.ptr );
+        }
+
+        auto append_number( data_t &o, double value ) -> void
+        {
+            if ( !std::isfinite( value ) )
+                value = 0;
+            if ( value == std::trunc( value ) && std::abs( value ) <= std::numeric_limits<std::int32_t>::max( ) )
+                return append_number( o, static_cast<std::int64_t>( value ) );
+            // PDF has no exponent notation, fixed notation of the largest double needs 309 digits
+            char buf[ 512 ];
+            auto res = std::to_chars( buf, buf + sizeof( buf ), value, std::chars_format::fixed );
+            o.append( buf, res.ptr );
+        }
+
+        auto append_name( data_t &o, std::string_view name ) -> void
+        {
+            o += '/';
+            for ( unsigned char c : name )
+            {
+                if ( c < 0x21 || c > 0x7E || c == '#' ||
+                     std::string_view( "()<>[]{}/%" ).find( static_cast<char>( c ) ) != std::string_view::npos )
+                {
+                    o += '#';
+                    o += hex_digits[ c >> 4 ];
+                    o += hex_digits[ c & 0xF ];
+                }
+                else
+                    o += static_cast<char>( c );
+            }
+        }
+
+        auto append_string( data_t &o, std::string_view str ) -> void
+        {
+            // binary strings are shorter as hex strings
+            auto binary = std::ranges::count_if( str, []( unsigned char c ) { return c < 0x20 || c > 0x7E; } );
+            if ( binary * 4 > static_cast<std::ptrdiff_t>( str.size( ) ) )
+            {
+                o += '<';
+                for ( unsigned char c : str )
+                {
+                    o += hex_digits[ c >> 4 ];
+                    o += hex_digits[ c & 0xF ];
+                }
+                o += '>';
+                return;
+            }
+            o += '(';
+            for ( char c : str )
+            {
+                if ( c == '(' || c == ')' || c == '\\' )
+                    o += '\\';
+                // an unescaped carriage return would be read as a line feed
+                if ( c == '\r' )
+                    o += "\\r";
+                else
+                    o += c;
+            }
+            o += ')';
+        }
+
+        // trailer entries that describe a cross-reference section and are written by the writer itself
+        auto is_xref_key( const PDFName &key ) -> bool
+        {
+            switch ( key.id )
+            {
+            case names::Size:
+            case names::Prev:
+            case names::Type:
+            case names::W:
+            case names::Index:
+            case names::Filter:
+            case names::DecodeParms:
+            case names::Length:
+            case names::DL:
+            case names::XRefStm:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // number of bytes needed to store value, at least one
+        auto byte_width( std::uint64_t value ) -> std::size_t
+        {
+            std::size_t width = 1;
+            while ( value >>= 8 )
+                ++width;
+            return width;
+        }
+    } // namespace
+
+    PDFWriter::PDFWriter( std::shared_ptr<PDFContext> ctx, PDFWriteOptions options )
+        : context( std::move( ctx ) ), options( options )
+    {
+        if ( this->options.objects_per_stream == 0 )
+            this->options.object_streams = false;
+    }
+
+    PDFWriter::PDFWriter( std::ostream &s, PDFWriteOptions options ) : options( options ), sink( &s )
+    {
+        if ( this->options.objects_per_stream == 0 )
+            this->options.object_streams = false;
+    }
+
+    auto PDFWriter::write( ) -> data_t
+    {
+        if ( !context )
+            throw std::runtime_error( "writer has no document to write" );
+        sink = nullptr;
+        write_document( );
+        return std::move( out );
+    }
+
+    auto PDFWriter::write( std::ostream &s ) -> void
+    {
+        if ( !context )
+            throw std::runtime_error( "writer has no document to write" );
+        sink = &s;
+        write_document( );
+        flush( );
+    }
+
+    auto PDFWriter::write_document( ) -> void
+    {
+        auto trailer = context->trailer;
+        if ( !trailer || !trailer->has( names::Root ) )
+            throw std::runtime_error( "missing required Root entry in Trailer Dictionary" );
+
+        out = "%PDF-1.7\n%\xE2\xE3\xCF\xD3\n";
+        renumber = true;
+        base_offset = 0;
+        entries = { XRefEntry( 0, 0, 65535, 0 ) };
+
+        // the trailer decides which objects are reachable, entries describing the old file structure are dropped
+        data_t trailer_entries;
+        for ( const auto &[ key, value ] : trailer->dict )
+            if ( key->id == names::Root || key->id == names::Info || key->id == names::ID )
+            {
+                append_name( trailer_entries, key->name );
+                trailer_entries += ' ';
+                write_value( value, trailer_entries );
+            }
+
+        while ( !pending.empty( ) )
+        {
+            auto [ ref, number ] = pending.front( );
+            pending.pop_front( );
+            write_object( number, context->get_object( ref ) );
+            flush( );
+        }
+        flush_object_stream( );
+        write_xref( trailer_entries, entries.size( ) );
+    }
+
+    auto PDFWriter::begin( ) -> void
+    {
+        out = "%PDF-1.7\n%\xE2\xE3\xCF\xD3\n";
+        renumber = false;
+        base_offset = 0;
+        entries = { XRefEntry( 0, 0, 65535, 0 ) };
+        flush( );
+    }
+
+    auto PDFWriter::reserve( ) -> std::shared_ptr<PDFRef>
+    {
+        return std::make_shared<PDFRef>( next_number++, 0, 1 );
+    }
+
+    auto PDFWriter::add_object( const std::shared_ptr<PDFBaseObject> &obj, std::shared_ptr<PDFRef> ref )
+        -> std::shared_ptr<PDFRef>
+    {
+        if ( !ref )
+            ref = reserve( );
+        if ( ref->object_number < entries.size( ) && entries[ ref->object_number ].type != XRefEntry::missing )
+            throw std::runtime_error( "object was already written" );
+        write_object( ref->object_number, obj );
+        flush( );
+        return ref;
+    }
+
+    auto PDFWriter::add_stream( const std::shared_ptr<PDFDictionary> &dict,
+                                const std::function<void( const consumer_t & )> &producer,
+                                std::shared_ptr<PDFRef> ref ) -> std::shared_ptr<PDFRef>
+    {
+        if ( !ref )
+            ref = reserve( );
+        if ( ref->object_number < entries.size( ) && entries[ ref->object_number ].type != XRefEntry::missing )
+            throw std::runtime_error( "object was already written" );
+        // the length is only known once the content is written
+        auto length = reserve( );
+        auto compress = !dict->has( names::Filter );
+
+        begin_object( ref->object_number );
+        out += "<<";
+        for ( const auto &[ key, value ] : dict->dict )
+        {
+            if ( key->id == names::Length || ( compress && ( key->id == names::DecodeParms || key->id == names::DL ) ) )
+                continue;
+            append_name( out, key->name );
+            out += ' ';
+            write_value( value, out );
+        }
+        if ( compress )
+            out += "/Filter/FlateDecode";
+        out += "/Length ";
+        append_number( out, static_cast<std::int64_t>( length->object_number ) );
+        out += " 0 R>>\nstream\n";
+
+        auto start = base_offset + out.size( );
+        if ( compress )
+        {
+            DeflateStream deflater( options.compression_level );
+            producer( [ & ]( in_data_t data ) {
+                deflater.write( data, out );
+                flush( );
+            } );
+            deflater.finish( out );
+        }
+        else
+            producer( [ & ]( in_data_t data ) {
+                out += data;
+                flush( );
+            } );
+        auto size = base_offset + out.size( ) - start;
+        // lengths are stored as PDF integers, which readers only support up to 2^31 - 1
+        if ( size > static_cast<std::size_t>( std::numeric_limits<std::int32_t>::max( ) ) )
+            throw std::runtime_error( "stream is too large for its Length" );
+        out += "\nendstream\nendobj\n";
+        write_object( length->object_number, std::make_shared<PDFInteger>( static_cast<std::int32_t>( size ) ) );
+        flush( );
+        return ref;
+    }
+
+    auto PDFWriter::finish( const std::shared_ptr<PDFDictionary> &trailer ) -> void
+    {
+        if ( !trailer || !trailer->has( names::Root ) )
+            throw std::runtime_error( "missing required Root entry in Trailer Dictionary" );
+        flush_object_stream( );
+        data_t trailer_entries;
+        for ( const auto &[ key, value ] : trailer->dict )
+        {
+            if ( is_xref_key( *key ) )
+                continue;
+            append_name( trailer_entries, key->name );
+            trailer_entries += ' ';
+            write_value( value, trailer_entries );
+        }
+        write_xref( trailer_entries, next_number );
+        flush( );
+    }
+
+    auto PDFWriter::flush( ) -> void
+    {
+        if ( sink == nullptr || out.empty( ) )
+            return;
+        sink->write( out.data( ), static_cast<std::streamsize>( out.size( ) ) );
+        if ( !*sink )
+            throw std::runtime_error( "failed to write document" );
+        base_offset += out.size( );
+        out.clear( );
+    }
+
+    auto PDFWriter::compress( in_data_t data ) const -> data_t
+    {
+        return PDFFlateFilter( options.compression_level, parallel_flate_threshold, options.thread_pool )
+            .encode( data, nullptr );
+    }
+
+    auto PDFWriter::append( std::size_t offset ) -> data_t
+    {
+        auto trailer = context->trailer;
+        if ( trailer->has( names::Encrypt ) )
+            throw std::runtime_error( "incremental updates of encrypted documents are not supported" );
+
+        renumber = false;
+        base_offset = offset;
+        // the original file does not have to end with a line break
+        out = "\n";
+        entries.clear( );
+
+        for ( const auto &[ ref, obj ] : context->get_modified_objects( ) )
+        {
+            if ( auto stream = obj->to<PDFStream>( ) )
+            {
+                if ( stream->stream_type == PDFStreamType::Raw )
+                    write_stream( ref->object_number, stream, ref->generation_number );
+                continue;
+            }
+            begin_object( ref->object_number, ref->generation_number );
+            write_value( obj, out );
+            out += "\nendobj\n";
+        }
+
+        // everything describing the old cross-reference sections is replaced
+        data_t trailer_entries = "/Prev ";
+        append_number( trailer_entries, static_cast<std::int64_t>( context->startxref ) );
+        for ( const auto &[ key, value ] : trailer->dict )
+        {
+            if ( is_xref_key( *key ) )
+                continue;
+            append_name( trailer_entries, key->name );
+            trailer_entries += ' ';
+            write_value( value, trailer_entries );
+        }
+
+        // updates use the kind of cross-reference section the document already uses
+        auto type = trailer->get<PDFName>( names::Type, false );
+        if ( type && type->id == names::XRef )
+        {
+            next_number = context->next_object_number++;
+            write_xref( trailer_entries, context->next_object_number );
+        }
+        else
+            write_xref_table( trailer_entries, context->next_object_number );
+        return std::move( out );
+    }
+
+    auto PDFWriter::write_value( const std::shared_ptr<PDFBaseObject> &obj, data_t &o ) -> void
+    {
+        if ( obj == nullptr )
+        {
+            o += "null";
+            return;
+        }
+        switch ( obj->type )
+        {
+        case PDFObjectType::Null:
+            o += "null";
+            break;
+        case PDFObjectType::Bool:
+            o += obj->as<PDFBool>( )->value ? "true" : "false";
+            break;
+        case PDFObjectType::Number:
+            append_number( o, obj->as<PDFNumber>( )->as_double( ) );
+            break;
+        case PDFObjectType::String:
+            append_string( o, obj->as<PDFString>( )->get_data( ) );
+            break;
+        case PDFObjectType::Name:
+            append_name( o, obj->as<PDFName>( )->name );
+            break;
+        case PDFObjectType::IndirectObject: {
+            auto ref = obj->as<PDFRef>( );
+            if ( renumber )
+            {
+                append_number( o, static_cast<std::int64_t>( number_of( ref ) ) );
+                o += " 0 R";
+                break;
+            }
+            append_number( o, static_cast<std::int64_t>( ref->object_number ) );
+            o += ' ';
+            append_number( o, static_cast<std::int64_t>( ref->generation_number ) );
+            o += " R";
+            break;
+        }
+        case PDFObjectType::Array: {
+            o += '[';
+            auto first = true;
+            for ( const auto &item : obj->as<PDFArray>( )->value )
+            {
+                if ( !first )
+                    o += ' ';
+                first = false;
+                write_value( item, o );
+            }
+            o += ']';
+            break;
+        }
+        case PDFObjectType::Dictionary: {
+            o += "<<";
+            for ( const auto &[ key, value ] : obj->as<PDFDictionary>( )->dict )
+            {
+                append_name( o, key->name );
+                o += ' ';
+                write_value( value, o );
+            }
+            o += ">>";
+            break;
+        }
+        default:
+            throw std::runtime_error( "object can not be written as a direct object" );
+        }
+    }
+
+    auto PDFWriter::number_of( const std::shared_ptr<PDFRef> &ref ) -> std::uint32_t
+    {
+        auto key = static_cast<std::uint64_t>( ref->object_number ) << 32 | ref->generation_number;
+        auto [ it, inserted ] = numbers.try_emplace( key, next_number );
+        if ( inserted )
+            pending.emplace_back( ref, next_number++ );
+        return it->second;
+    }
+
+    auto PDFWriter::write_object( std::uint32_t number, const std::shared_ptr<PDFBaseObject> &obj ) -> void
+    {
+        auto value = obj;
+        if ( auto stream = obj->to<PDFStream>( ) )
+        {
+            if ( stream->stream_type == PDFStreamType::Raw )
+                return write_stream( number, stream );
+            // object and XRef streams of the source are replaced by the ones written here
+            value = nullptr;
+        }
+
+        if ( !options.object_streams )
+        {
+            begin_object( number );
+            write_value( value, out );
+            out += "\nendobj\n";
+            return;
+        }
+        // the object stream number is known once the stream is flushed
+        set_entry( number, XRefEntry( 0, number, static_cast<std::uint32_t>( stream_numbers.size( ) ), 2 ) );
+        append_number( stream_offsets, static_cast<std::int64_t>( number ) );
+        stream_offsets += ' ';
+        append_number( stream_offsets, static_cast<std::int64_t>( stream_objects.size( ) ) );
+        stream_offsets += ' ';
+        write_value( value, stream_objects );
+        stream_objects += '\n';
+        stream_numbers.push_back( number );
+        if ( stream_numbers.size( ) >= options.objects_per_stream )
+            flush_object_stream( );
+    }
+
+    auto PDFWriter::write_stream( std::uint32_t number, const std::shared_ptr<PDFStream> &stream,
+                                  std::uint32_t generation ) -> void
+    {
+        // streams that were decoded losslessly are compressed again, others keep their original bytes and filters
+        auto reencode = stream->is_decoded( );
+        auto compressed = false;
+        data_t decoded;
+        data_t encoded;
+        in_data_t content = stream->raw( );
+        if ( reencode )
+        {
+            // streams that were not read are not kept decoded after they are written
+            decoded = stream->decode( );
+            encoded = compress( decoded );
+            // tiny streams grow when they are compressed
+            compressed = encoded.size( ) < decoded.size( );
+            content = compressed ? in_data_t( encoded ) : in_data_t( decoded );
+        }
+
+        begin_object( number, generation );
+        out += "<<";
+        for ( const auto &[ key, value ] : stream->dict->dict )
+        {
+            if ( key->id == names::Length || key->id == names::DL )
+                continue;
+            if ( reencode && ( key->id == names::Filter || key->id == names::DecodeParms ) )
+                continue;
+            append_name( out, key->name );
+            out += ' ';
+            write_value( value, out );
+        }
+        if ( compressed )
+            out += "/Filter/FlateDecode";
+        out += "/Length ";
+        append_number( out, static_cast<std::int64_t>( content.size( ) ) );
+        out += ">>\nstream\n";
+        out += content;
+        out += "\nendstream\nendobj\n";
+    }
+
+    auto PDFWriter::flush_object_stream( ) -> void
+    {
+        if ( stream_numbers.empty( ) )
+            return;
+        auto number = next_number++;
+        for ( auto n : stream_numbers )
+            entries[ n ].offset = number;
+
+        auto encoded = compress( stream_offsets + stream_objects );
+        begin_object( number );
+        out += "<</Type/ObjStm/N ";
+        append_number( out, static_cast<std::int64_t>( stream_numbers.size( ) ) );
+        out += "/First ";
+        append_number( out, static_cast<std::int64_t>( stream_offsets.size( ) ) );
+        out += "/Filter/FlateDecode/Length ";
+        append_number( out, static_cast<std::int64_t>( encoded.size( ) ) );
+        out += ">>\nstream\n";
+        out += encoded;
+        out += "\nendstream\nendobj\n";
+
+        stream_offsets.clear( );
+        stream_objects.clear( );
+        stream_numbers.clear( );
+    }
+
+    auto PDFWriter::write_xref( const data_t &trailer, std::size_t size ) -> void
+    {
+        auto number = next_number++;
+        auto offset = base_offset + out.size( );
+        startxref = offset;
+        set_entry( number, XRefEntry( static_cast<std::uint32_t>( offset ), number, 0, 1 ) );
+        size = std::max<std::size_t>( size, number + 1 );
+
+        // subsections of consecutive object numbers
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> sections;
+        std::uint64_t max_offset = 0;
+        std::uint64_t max_generation = 0;
+        for ( std::uint32_t i = 0; i < entries.size( ); ++i )
+        {
+            if ( entries[ i ].type == XRefEntry::missing )
+                continue;
+            if ( sections.empty( ) || sections.back( ).first + sections.back( ).second != i )
+                sections.emplace_back( i, 0 );
+            ++sections.back( ).second;
+            max_offset = std::max<std::uint64_t>( max_offset, entries[ i ].offset );
+            max_generation = std::max<std::uint64_t>( max_generation, entries[ i ].generation_number );
+        }
+        std::size_t widths[ 3 ] = { 1, byte_width( max_offset ), byte_width( max_generation ) };
+        auto columns = widths[ 0 ] + widths[ 1 ] + widths[ 2 ];
+
+        // rows are stored with the PNG up predictor, the high bytes of neighbouring offsets are mostly equal
+        data_t rows;
+        auto row = data_t( columns, '\0' );
+        auto prev = data_t( columns, '\0' );
+        for ( const auto &entry : entries )
+        {
+            if ( entry.type == XRefEntry::missing )
+                continue;
+            std::uint64_t fields[ 3 ] = { entry.type, entry.offset, entry.generation_number };
+            std::size_t pos = 0;
+            for ( std::size_t f = 0; f < 3; ++f )
+                for ( std::size_t b = widths[ f ]; b-- > 0; )
+                    row[ pos++ ] = static_cast<char>( fields[ f ] >> ( 8 * b ) );
+            rows += '\x02';
+            for ( std::size_t j = 0; j < columns; ++j )
+                rows += static_cast<char>( row[ j ] - prev[ j ] );
+            std::swap( row, prev );
+        }
+        auto encoded = compress( rows );
+
+        begin_object( number );
+        out += "<</Type/XRef/Size ";
+        append_number( out, static_cast<std::int64_t>( size ) );
+        if ( sections.size( ) != 1 || sections[ 0 ].first != 0 || sections[ 0 ].second != size )
+        {
+            out += "/Index[";
+            for ( std::size_t i = 0; i < sections.size( ); ++i )
+            {
+                if ( i != 0 )
+                    out += ' ';
+                append_number( out, static_cast<std::int64_t>( sections[ i ].first ) );
+                out += ' ';
+                append_number( out, static_cast<std::int64_t>( sections[ i ].second ) );
+            }
+            out += ']';
+        }
+        out += "/W[";
+        for ( std::size_t f = 0; f < 3; ++f )
+        {
+            append_number( out, static_cast<std::int64_t>( widths[ f ] ) );
+            out += f == 2 ? "]" : " ";
+        }
+        out += "/Filter/FlateDecode/DecodeParms<</Predictor 12/Columns ";
+        append_number( out, static_cast<std::int64_t>( columns ) );
+        out += ">>/Length ";
+        append_number( out, static_cast<std::int64_t>( encoded.size( ) ) );
+        out += trailer;
+        out += ">>\nstream\n";
+        out += encoded;
+        out += "\nendstream\nendobj\nstartxref\n";
+        append_number( out, static_cast<std::int64_t>( offset ) );
+        out += "\n%%EOF\n";
+    }
+
+    auto PDFWriter::write_xref_table( const data_t &trailer, std::size_t size ) -> void
+    {
+        auto offset = base_offset + out.size( );
+        startxref = offset;
+        out += "xref\n";
+        for ( std::uint32_t i = 0; i < entries.size( ); )
+        {
+            if ( entries[ i ].type == XRefEntry::missing )
+            {
+                ++i;
+                continue;
+            }
+            auto end = i;
+            while ( end < entries.size( ) && entries[ end ].type != XRefEntry::missing )
+                ++end;
+            out += std::format( "{} {}\n", i, end - i );
+            // every record is exactly 20 bytes long
+            for ( ; i < end; ++i )
+                out += std::format( "{:010} {:05} {}\r\n", entries[ i ].offset, entries[ i ].generation_number,
+                                    entries[ i ].type == 0 ? 'f' : 'n' );
+        }
+        out += "trailer\n<</Size ";
+        append_number( out, static_cast<std::int64_t>( size ) );
+        out += trailer;
+        out += ">>\nstartxref\n";
+        append_number( out, static_cast<std::int64_t>( offset ) );
+        out += "\n%%EOF\n";
+    }
+
+    auto PDFWriter::begin_object( std::uint32_t number, std::uint32_t generation ) -> void
+    {
+        auto offset = base_offset + out.size( );
+        if ( offset > std::numeric_limits<std::uint32_t>::max( ) )
+            throw std::runtime_error( "document is too large for the XRef table" );
+        set_entry( number, XRefEntry( static_cast<std::uint32_t>( offset ), number, generation, 1 ) );
+        append_number( out, static_cast<std::int64_t>( number ) );
+        out += ' ';
+        append_number( out, static_cast<std::int64_t>( generation ) );
+        out += " obj\n";
+    }
+
+    auto PDFWriter::set_entry( std::uint32_t number, XRefEntry entry ) -> void
+    {
+        if ( number >= entries.size( ) )
+            entries.resize( number + 1, XRefEntry( 0, 0, 0, XRefEntry::missing ) );
+        entries[ number ] = entry;
+    }
+} // namespace vrock::pdf
\ No newline at end of file
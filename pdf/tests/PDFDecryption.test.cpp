@@ -1,4 +1,6 @@
 #include <vrock/pdf/PDFDocument.hpp>
+#include <vrock/pdf/parser/PDFObjectParser.hpp>
+#include <vrock/utils/SpanHelpers.hpp>
 
 #include <gtest/gtest.h>
 
@@ -109,4 +111,62 @@ TEST( DecryptUeserOewner, BasicAssertions )
         EXPECT_EQ( sec->is_authenticated( ), true );
         EXPECT_EQ( sec->has_permission( Permissions::PrintDocument ), true );
     }
+}
+
+TEST( DecryptRoundTrip, BasicAssertions )
+{
+    std::vector<std::string> files = { "pdfs/Encrypted/R2_O.pdf", "pdfs/Encrypted/R3_O.pdf",
+                                       "pdfs/Encrypted/R4_O.pdf", "pdfs/Encrypted/R4_O_AES.pdf",
+                                       "pdfs/Encrypted/R5_O.pdf", "pdfs/Encrypted/R6_O.pdf" };
+    for ( const auto &file : files )
+    {
+        auto doc = PDFDocument( file );
+        auto sec = doc.decryption_handler->to<PDFStandardSecurityHandler>( );
+        ASSERT_NE( sec, nullptr );
+        auto page = doc.get_page( 0 );
+        ASSERT_NE( page, nullptr );
+        auto text = page->get_text( );
+        ASSERT_EQ( text.size( ), 1 ) << file;
+        EXPECT_EQ( text[ 0 ]->text, "Test" ) << file;
+
+        // the same object key is used again for every object and padding is removed
+        for ( auto ref : { std::make_shared<PDFRef>( 1, 0, 1 ), std::make_shared<PDFRef>( 70000, 2, 1 ),
+                           std::make_shared<PDFRef>( 1, 0, 1 ) } )
+            for ( std::size_t size : { 0, 1, 15, 16, 17, 1000 } )
+            {
+                auto data = std::string( size, 'x' );
+                EXPECT_EQ( sec->decrypt( sec->encrypt( data, ref ), ref ), data ) << file << " " << size;
+            }
+    }
+}
+
+TEST( DeferredDecryption, BasicAssertions )
+{
+    auto doc = PDFDocument( "pdfs/Encrypted/R4_O_AES.pdf" );
+    auto ref = std::make_shared<PDFRef>( 42, 0, 1 );
+    auto string = doc.decryption_handler->encrypt( "secret", ref );
+    auto content = doc.decryption_handler->encrypt( "BT (Test) Tj ET", ref );
+
+    auto parser = PDFObjectParser( std::format( "[<{}> <</Length {}>>stream\n{}\nendstream]",
+                                                vrock::utils::to_hex_string( string ), content.size( ), content ) );
+    parser.set_decryption_handler( doc.decryption_handler );
+    auto arr = parser.parse_array( ref, true );
+    ASSERT_EQ( arr->value.size( ), 2 );
+
+    // nothing is decrypted until the values are read
+    auto str = arr->get<PDFString>( 0, false );
+    auto stream = arr->get<PDFStream>( 1, false );
+    ASSERT_NE( str, nullptr );
+    ASSERT_NE( stream, nullptr );
+    EXPECT_EQ( str->get_size( ), string.size( ) );
+    EXPECT_EQ( stream->get_size( ), content.size( ) );
+    EXPECT_EQ( str->get_string( ), "secret" );
+    EXPECT_EQ( str->get_data( ), "secret" );
+    EXPECT_EQ( str->get_size( ), 6 );
+    EXPECT_EQ( stream->decoded( ), "BT (Test) Tj ET" );
+    EXPECT_EQ( stream->decoded( ), "BT (Test) Tj ET" );
+
+    str->set( "plain" );
+    EXPECT_EQ( str->get_size( ), 5 );
+    EXPECT_EQ( str->get_string( ), "plain" );
 }
\ No newline at end of file
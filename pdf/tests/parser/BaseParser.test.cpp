@@ -20,6 +20,33 @@ TEST( ParseInt, BasicAssertions )
     EXPECT_EQ( parser.parse_int( ), 0 );
 }
 
+TEST( ParseNumberForms, BasicAssertions )
+{
+    vrock::pdf::BaseParser parser( "+12 +.5 4. -.25 7 ", 0 );
+    EXPECT_EQ( parser.parse_int( ), 12 );
+    parser.skip_whitespace( );
+    EXPECT_EQ( parser.parse_double( ), 0.5 );
+    parser.skip_whitespace( );
+    EXPECT_EQ( parser.parse_double( ), 4.0 );
+    parser.skip_whitespace( );
+    EXPECT_EQ( parser.parse_double( ), -0.25 );
+    EXPECT_EQ( parser.parse_int( ), 7 );
+    EXPECT_EQ( parser.parse_int( ), 0 );
+}
+
+TEST( ParseInvalidNumbers, BasicAssertions )
+{
+    // signs and dots without digits are read as 0
+    vrock::pdf::BaseParser parser( "- . -. + 99999999999", 0 );
+    EXPECT_EQ( parser.parse_double( ), 0.0 );
+    parser.skip_whitespace( );
+    EXPECT_EQ( parser.parse_double( ), 0.0 );
+    parser.skip_whitespace( );
+    EXPECT_EQ( parser.parse_double( ), 0.0 );
+    EXPECT_EQ( parser.parse_int( ), 0 );
+    EXPECT_THROW( parser.parse_int( ), vrock::pdf::PDFParserException );
+}
+
 TEST( Is, BasicAssertion )
 {
     vrock::pdf::BaseParser parser( "\t<1-.", 0 );
@@ -62,4 +89,12 @@ TEST( IsKeyword, BasicAssertion )
     EXPECT_EQ( parser.is_keyword( "xref" ), true );
     parser.skip_whitespace( );
     EXPECT_EQ( parser.is_keyword( "obj" ), true );
+}
+
+TEST( IsKeywordAtEnd, BasicAssertion )
+{
+    vrock::pdf::BaseParser parser( "end", 0 );
+    EXPECT_EQ( parser.is_keyword( "endobj" ), false );
+    EXPECT_EQ( parser.is_keyword( "end" ), true );
+    EXPECT_EQ( parser.is_keyword( "end" ), false );
 }
\ No newline at end of file
@@ -28,4 +28,121 @@ TEST( ParseOperatorCm, BasicAssertions )
     EXPECT_EQ( mat[ 2 ][ 0 ], 102.6 );
     EXPECT_EQ( mat[ 2 ][ 1 ], 236.5 );
     EXPECT_EQ( mat[ 2 ][ 2 ], 1.0 );
+}
+
+TEST( DecodeOperator, BasicAssertions )
+{
+    for ( std::size_t i = 0; i + 1 < operator_count; i++ )
+        EXPECT_EQ( decode_operator( operator_names[ i ] ), static_cast<ContentStreamOperator>( i ) );
+    EXPECT_EQ( decode_operator( "Tj" ), ContentStreamOperator::Tj );
+    EXPECT_EQ( decode_operator( "T*" ), ContentStreamOperator::Tst );
+    EXPECT_EQ( decode_operator( "xyz" ), ContentStreamOperator::Unknown );
+    EXPECT_EQ( decode_operator( "BDCX" ), ContentStreamOperator::Unknown );
+    EXPECT_EQ( decode_operator( "" ), ContentStreamOperator::Unknown );
+}
+
+TEST( CompileContent, BasicAssertions )
+{
+    auto [ res, ctx ] = create_res_dict( );
+    auto program = compile_content( "q 1 0 0 1 72 720 cm /F1 12 Tf % comment\n(Hi) Tj [(a) -20 (b)] TJ true Q 5", ctx );
+
+    ASSERT_EQ( program->instructions.size( ), 6 );
+    EXPECT_EQ( program->instructions[ 0 ].op, ContentStreamOperator::q );
+    EXPECT_EQ( program->instructions[ 0 ].count, 0 );
+
+    auto cm = ContentOperands( *program, program->instructions[ 1 ] );
+    EXPECT_EQ( cm.op( ), ContentStreamOperator::cm );
+    ASSERT_EQ( cm.size( ), 6 );
+    EXPECT_EQ( cm.number( 4 ), 72.0 );
+    EXPECT_EQ( cm.number( 5 ), 720.0 );
+
+    auto tf = ContentOperands( *program, program->instructions[ 2 ] );
+    EXPECT_EQ( tf.name( 0 ), "F1" );
+    EXPECT_THROW( (void)tf.number( 0 ), PDFParserException );
+    EXPECT_EQ( tf.number( 1 ), 12.0 );
+
+    auto tj = ContentOperands( *program, program->instructions[ 3 ] );
+    ASSERT_NE( tj.object<PDFString>( 0 ), nullptr );
+    EXPECT_EQ( tj.object<PDFString>( 0 )->get_string( ), "Hi" );
+    EXPECT_THROW( (void)tj.name( 0 ), PDFParserException );
+
+    auto tj_array = ContentOperands( *program, program->instructions[ 4 ] );
+    ASSERT_NE( tj_array.object<PDFArray>( 0 ), nullptr );
+    EXPECT_EQ( tj_array.object<PDFArray>( 0 )->value.size( ), 3 );
+
+    // operands after the last operator are dropped
+    auto q = ContentOperands( *program, program->instructions[ 5 ] );
+    EXPECT_EQ( q.op( ), ContentStreamOperator::Q );
+    EXPECT_EQ( q.size( ), 1 );
+    EXPECT_EQ( program->operands.size( ), 11 );
+
+    // a malformed number does not end the stream
+    auto malformed = compile_content( "1 0 0 1 - . cm Q", ctx );
+    ASSERT_EQ( malformed->instructions.size( ), 2 );
+    EXPECT_EQ( ContentOperands( *malformed, malformed->instructions[ 0 ] ).number( 4 ), 0.0 );
+
+    // a stray delimiter is no operator and must not be skipped forever
+    EXPECT_THROW( compile_content( "q 1 0 0 1 0 0 cm ] Q", ctx ), PDFParserException );
+    EXPECT_THROW( compile_content( "q _ Q", ctx ), PDFParserException );
+}
+
+TEST( ExecuteCompiledContent, BasicAssertions )
+{
+    auto [ res, ctx ] = create_res_dict( );
+    auto program = compile_content( "2 0 0 2 10 20 cm (Hello) Tj [(a) -20 (b)] TJ", ctx );
+    for ( int i = 0; i < 2; i++ )
+    {
+        ContentStreamParser parser( program, res, ctx );
+        auto mat = parser.graphic_state_stack.top( ).current_transformation_matrix;
+        EXPECT_EQ( mat[ 0 ][ 0 ], 2.0 );
+        EXPECT_EQ( mat[ 2 ][ 1 ], 20.0 );
+        ASSERT_EQ( parser.text.size( ), 2 );
+        EXPECT_EQ( parser.text[ 0 ]->text, "Hello" );
+        EXPECT_EQ( parser.text[ 1 ]->text, "ab" );
+    }
+
+    // operands of the wrong type reject the operator instead of executing it with made up values
+    for ( const auto *data : { "(a) 0 0 2 10 20 cm 2 0 0 2 10 20 cm", "/a Tc 2 0 0 2 10 20 cm" } )
+    {
+        ContentStreamParser parser( compile_content( data, ctx ), res, ctx );
+        EXPECT_EQ( parser.graphic_state_stack.top( ).current_transformation_matrix[ 0 ][ 0 ], 1.0 );
+        EXPECT_EQ( parser.graphic_state_stack.top( ).text_state.character_spacing, 0.0 );
+    }
+}
+
+TEST( StreamContent, BasicAssertions )
+{
+    auto [ res, ctx ] = create_res_dict( );
+    auto dict = std::make_shared<PDFDictionary>( ctx );
+    // streams may only be split between tokens, operands can still belong to an operator in the next stream
+    std::vector<std::shared_ptr<PDFStream>> streams = {
+        std::make_shared<PDFStream>( dict, "(Hello) Tj 2 0 0" ),
+        std::make_shared<PDFStream>( dict, "2 10 20 cm [(a) -20 (b)] TJ" ),
+    };
+
+    std::vector<ContentStreamOperator> ops;
+    std::vector<std::size_t> sizes;
+    for ( const auto &op : stream_content( streams, ctx ) )
+    {
+        ops.push_back( op.op( ) );
+        sizes.push_back( op.size( ) );
+    }
+    EXPECT_EQ( ops, std::vector<ContentStreamOperator>(
+                        { ContentStreamOperator::Tj, ContentStreamOperator::cm, ContentStreamOperator::TJ } ) );
+    EXPECT_EQ( sizes, std::vector<std::size_t>( { 1, 6, 1 } ) );
+
+    auto program = compile_content( streams, ctx );
+    EXPECT_EQ( program->instructions.size( ), 3 );
+
+    ContentStreamParser interpreter( res, ctx );
+    interpreter.interpret( streams );
+    EXPECT_EQ( interpreter.graphic_state_stack.top( ).current_transformation_matrix[ 2 ][ 1 ], 20.0 );
+    ASSERT_EQ( interpreter.text.size( ), 2 );
+    EXPECT_EQ( interpreter.text[ 1 ]->text, "ab" );
+
+    // stopping after the first text does not execute the rest
+    ContentStreamParser partial( res, ctx );
+    partial.interpret( streams, [ & ] { return !partial.text.empty( ); } );
+    ASSERT_EQ( partial.text.size( ), 1 );
+    EXPECT_EQ( partial.graphic_state_stack.top( ).current_transformation_matrix[ 2 ][ 1 ], 0.0 );
 }
\ No newline at end of file
@@ -0,0 +1,25 @@
+#include <gtest/gtest.h>
+
+#include <vrock/pdf/PDFDocument.hpp>
+#include <vrock/pdf/parser/InputSource.hpp>
+
+using namespace vrock::pdf;
+
+TEST( InputSource, MappedEqualsBuffered )
+{
+    std::vector<std::string> files = { "pdfs/simple.pdf", "pdfs/sample_form.pdf", "pdfs/with_update_sections.pdf" };
+    for ( const auto &file : files )
+    {
+        auto buffered = read_file( file );
+        auto mapped = map_file( file );
+        EXPECT_EQ( buffered->view( ).size( ), std::filesystem::file_size( file ) );
+        EXPECT_EQ( buffered->view( ), mapped->view( ) );
+    }
+}
+
+TEST( InputSource, OpenMemoryMapped )
+{
+    auto buffered = PDFDocument( "pdfs/with_update_sections.pdf" );
+    auto mapped = PDFDocument( "pdfs/with_update_sections.pdf", PDFOpenMode::MemoryMapped );
+    EXPECT_EQ( mapped.get_page_count( ), buffered.get_page_count( ) );
+}
\ No newline at end of file
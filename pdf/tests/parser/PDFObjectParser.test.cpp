@@ -1,7 +1,11 @@
 #include "vrock/pdf/parser/PDFObjectParser.hpp"
 
+#include <vrock/utils/ThreadPool.hpp>
+
 #include <gtest/gtest.h>
 
+#include <format>
+
 using namespace vrock::pdf;
 
 TEST( ParsePDFName, BasicAssertions )
@@ -131,14 +135,14 @@ TEST( ParseDictionaryOrStream, BasicAssertions )
         PDFObjectParser parser( "<</Length 4>>stream\nTest\nendstream" );
         auto stream = parser.parse_dictionary_or_stream( nullptr, false );
         EXPECT_EQ( stream->type, PDFObjectType::Stream );
-        auto tmp = std::string( stream->to<PDFStream>( )->data );
-        EXPECT_EQ( stream->to<PDFStream>( )->data, "Test" );
+        auto tmp = std::string( stream->to<PDFStream>( )->decoded( ) );
+        EXPECT_EQ( stream->to<PDFStream>( )->decoded( ), "Test" );
     }
     {
         PDFObjectParser parser( "<<>>\nstream\nTest\nendstream" );
         auto stream = parser.parse_dictionary_or_stream( nullptr, false );
         EXPECT_EQ( stream->type, PDFObjectType::Stream );
-        EXPECT_EQ( stream->to<PDFStream>( )->data, "Test" );
+        EXPECT_EQ( stream->to<PDFStream>( )->decoded( ), "Test" );
     }
     {
         PDFObjectParser parser( "<</Length 5/Test /Test /Active true>>" );
@@ -148,6 +152,64 @@ TEST( ParseDictionaryOrStream, BasicAssertions )
         EXPECT_EQ( dict->to<PDFDictionary>( )->get<PDFName>( "Test" )->name, "Test" );
         EXPECT_EQ( dict->to<PDFDictionary>( )->get<PDFBool>( "Active" )->value, true );
     }
+    {
+        // broken /Length, the end has to be searched
+        PDFObjectParser parser( "<</Length 2>>stream\r\nsee the end\r\nendstream endobj" );
+        auto stream = parser.parse_dictionary_or_stream( nullptr, false );
+        EXPECT_EQ( stream->to<PDFStream>( )->decoded( ), "see the end" );
+        parser.skip_whitespace( );
+        EXPECT_TRUE( parser.is_keyword( "endobj" ) );
+    }
+    {
+        PDFObjectParser parser( "<<>>stream\nendstrea\rendstream" );
+        auto stream = parser.parse_dictionary_or_stream( nullptr, false );
+        EXPECT_EQ( stream->to<PDFStream>( )->decoded( ), "endstrea" );
+    }
+    {
+        // filters run when the content is read
+        PDFObjectParser parser( "<</Filter /ASCIIHexDecode /Length 9>>stream\n54657374>\nendstream" );
+        auto stream = parser.parse_dictionary_or_stream( nullptr, false )->to<PDFStream>( );
+        ASSERT_NE( stream, nullptr );
+        EXPECT_EQ( stream->raw( ), "54657374>" );
+        EXPECT_EQ( stream->get_size( ), 9 );
+        EXPECT_EQ( stream->decode( ), "Test" );
+        EXPECT_EQ( stream->get_size( ), 9 );
+        EXPECT_EQ( stream->decoded( ), "Test" );
+        EXPECT_EQ( stream->get_size( ), 4 );
+        stream->release( );
+        EXPECT_EQ( stream->get_size( ), 9 );
+        EXPECT_EQ( stream->decoded( ), "Test" );
+    }
+    {
+        // objects of an object stream are parsed from data owned by its parser
+        PDFObjectParser parser( "<</Type /ObjStm /N 2 /First 8 /Length 14>>stream\n5 0 6 3 42 (a)\nendstream" );
+        parser.set_context( std::make_shared<PDFContext>( nullptr ) );
+        auto stream = parser.parse_dictionary_or_stream( nullptr, false )->to<PDFStream>( );
+        ASSERT_NE( stream, nullptr );
+        auto object_stream = stream->to_stream<PDFObjectStream>( );
+        ASSERT_NE( object_stream, nullptr );
+        object_stream->release( );
+        EXPECT_EQ( object_stream->get_object( 0 )->to<PDFInteger>( )->value, 42 );
+        EXPECT_EQ( object_stream->get_object( 1 )->to<PDFString>( )->get_string( ), "a" );
+    }
+    {
+        PDFObjectParser parser( "<<>>stream\nno end" );
+        EXPECT_THROW( parser.parse_dictionary_or_stream( nullptr, false ), PDFParserException );
+    }
+}
+
+TEST( FindKeyword, BasicAssertions )
+{
+    PDFObjectParser parser( "startxref 1 startxref 2 %%EOF" );
+    EXPECT_EQ( parser.find( "startxref", 0 ), 0 );
+    EXPECT_EQ( parser.find( "startxref", 1 ), 12 );
+    EXPECT_EQ( parser.find( "startxref", 13 ), std::string_view::npos );
+    EXPECT_EQ( parser.find( "EOF", 0 ), 26 );
+    EXPECT_EQ( parser.rfind( "startxref" ), 12 );
+    EXPECT_EQ( parser.rfind( "missing" ), std::string_view::npos );
+
+    auto large = PDFObjectParser( "startxref" + std::string( 5000, ' ' ) );
+    EXPECT_EQ( large.rfind( "startxref" ), 0 );
 }
 
 TEST( ParseArray, BasicAssertions )
@@ -207,31 +269,146 @@ TEST( ParseXref, BasicAssertions )
     auto context = std::make_shared<PDFContext>( std::shared_ptr<PDFObjectParser>( &parser ) );
     parser.set_context( context );
     auto xrefs = parser.parse_xref( );
-    auto check_entry = []( const std::shared_ptr<XRefEntry> &e1, XRefEntry e2 ) {
+    auto check_entry = []( const XRefEntry *e1, XRefEntry e2 ) {
+        ASSERT_NE( e1, nullptr );
         EXPECT_EQ( e1->offset, e2.offset );
         EXPECT_EQ( e1->object_number, e2.object_number );
         EXPECT_EQ( e1->generation_number, e2.generation_number );
         EXPECT_EQ( e1->type, e2.type );
     };
-    auto make_entry = []( int num, int gen ) { return std::make_shared<XRefEntry>( 0, num, gen, 0 ); };
 
     EXPECT_EQ( xrefs.size( ), 2 );
     auto &xref1 = xrefs[ 0 ]; // normal text based
     auto &xref2 = xrefs[ 1 ]; // XRefStream
-    EXPECT_EQ( xref1->entries.size( ), 6 );
-    check_entry( xref1->entries[ make_entry( 0, 65535 ) ], { 3, 0, 65535, 0 } );
-    check_entry( xref1->entries[ make_entry( 1, 0 ) ], { 17, 1, 0, 1 } );
-    check_entry( xref1->entries[ make_entry( 2, 0 ) ], { 81, 2, 0, 1 } );
-    check_entry( xref1->entries[ make_entry( 3, 7 ) ], { 0, 3, 7, 0 } );
-    check_entry( xref1->entries[ make_entry( 4, 0 ) ], { 331, 4, 0, 1 } );
-    check_entry( xref1->entries[ make_entry( 5, 0 ) ], { 409, 5, 0, 1 } );
-    EXPECT_EQ( xref2->entries.size( ), 8 );
-    check_entry( xref2->entries[ make_entry( 0, 65535 ) ], { 0, 0, 65535, 0 } );
-    check_entry( xref2->entries[ make_entry( 1, 0 ) ], { 18212, 1, 0, 1 } );
-    check_entry( xref2->entries[ make_entry( 2, 0 ) ], { 13, 2, 0, 0 } );
-    check_entry( xref2->entries[ make_entry( 3, 0 ) ], { 19212, 3, 0, 1 } );
-    check_entry( xref2->entries[ make_entry( 8, 0 ) ], { 1, 8, 0, 2 } );
-    check_entry( xref2->entries[ make_entry( 9, 0 ) ], { 1, 9, 1, 2 } );
-    check_entry( xref2->entries[ make_entry( 10, 0 ) ], { 1, 10, 2, 2 } );
-    check_entry( xref2->entries[ make_entry( 11, 0 ) ], { 1, 11, 3, 2 } );
+    EXPECT_EQ( xref1->size( ), 6 );
+    check_entry( xref1->get_entry( 0 ), { 3, 0, 65535, 0 } );
+    check_entry( xref1->get_entry( 1 ), { 17, 1, 0, 1 } );
+    check_entry( xref1->get_entry( 2 ), { 81, 2, 0, 1 } );
+    check_entry( xref1->get_entry( 3 ), { 0, 3, 7, 0 } );
+    check_entry( xref1->get_entry( 4 ), { 331, 4, 0, 1 } );
+    check_entry( xref1->get_entry( 5 ), { 409, 5, 0, 1 } );
+    EXPECT_EQ( xref2->size( ), 8 );
+    EXPECT_EQ( xref2->get_entry( 4 ), nullptr );
+    check_entry( xref2->get_entry( 0 ), { 0, 0, 65535, 0 } );
+    check_entry( xref2->get_entry( 1 ), { 18212, 1, 0, 1 } );
+    check_entry( xref2->get_entry( 2 ), { 13, 2, 0, 0 } );
+    check_entry( xref2->get_entry( 3 ), { 19212, 3, 0, 1 } );
+    check_entry( xref2->get_entry( 8 ), { 1, 8, 0, 2 } );
+    check_entry( xref2->get_entry( 9 ), { 1, 9, 1, 2 } );
+    check_entry( xref2->get_entry( 10 ), { 1, 10, 2, 2 } );
+    check_entry( xref2->get_entry( 11 ), { 1, 11, 3, 2 } );
+
+    // newer entries override older ones
+    XRefTable merged;
+    merged.merge( *xref2 );
+    merged.merge( *xref1 );
+    EXPECT_EQ( merged.size( ), 10 );
+    check_entry( merged.get_entry( 1 ), { 17, 1, 0, 1 } );
+    check_entry( merged.get_entry( 8 ), { 1, 8, 0, 2 } );
+    EXPECT_EQ( merged.get_entry( 6 ), nullptr );
+}
+
+TEST( ParseLargeXref, BasicAssertions )
+{
+    // large enough to be decoded on the thread pool
+    constexpr std::size_t count = 200000;
+    auto data = std::format( "xref\n0 {}\n", count );
+    for ( std::size_t i = 0; i < count; ++i )
+        data += std::format( "{:010} {:05} {} \n", i * 10, i % 3, i % 5 == 0 ? 'f' : 'n' );
+    // a record with a single byte end of line is handled by the tokenizer
+    data += "7 2\n0000000070 00001 n\n0000000080 00000 f\ntrailer\n<</Size 200000>>\nstartxref\n0\n%%EOF";
+    PDFObjectParser parser( data );
+    vrock::utils::ThreadPool pool( 4 );
+    auto xrefs = parser.parse_xref( pool );
+    ASSERT_EQ( xrefs.size( ), 1 );
+    auto &xref = xrefs[ 0 ];
+    EXPECT_EQ( xref->size( ), count );
+    for ( std::uint32_t i : { 0u, 1u, 9u, 65536u, 123457u, 199999u } )
+    {
+        auto entry = xref->get_entry( i );
+        ASSERT_NE( entry, nullptr );
+        EXPECT_EQ( entry->offset, i * 10 );
+        EXPECT_EQ( entry->object_number, i );
+        EXPECT_EQ( entry->generation_number, i % 3 );
+        EXPECT_EQ( entry->type, i % 5 == 0 ? 0 : 1 );
+    }
+    EXPECT_EQ( xref->get_entry( 7 )->generation_number, 1 );
+    EXPECT_EQ( xref->get_entry( 8 )->offset, 80 );
+    EXPECT_EQ( xref->get_entry( 8 )->type, 0 );
+    EXPECT_NE( xref->trailer, nullptr );
+}
+
+TEST( XRefStreamWidths, BasicAssertions )
+{
+    auto entries = []( const std::string &dict, const std::string &data ) {
+        PDFObjectParser parser( dict );
+        return PDFXRefStream( parser.parse_dictionary( nullptr, false ), data ).get_entries( );
+    };
+    auto check_entry = []( const XRefEntry &e1, XRefEntry e2 ) {
+        EXPECT_EQ( e1.offset, e2.offset );
+        EXPECT_EQ( e1.object_number, e2.object_number );
+        EXPECT_EQ( e1.generation_number, e2.generation_number );
+        EXPECT_EQ( e1.type, e2.type );
+    };
+
+    auto e = entries( "<</Size 2/W [1 2 1]>>", std::string( "\x01\x12\x34\x00\x02\x00\x05\x03", 8 ) );
+    ASSERT_EQ( e.size( ), 2 );
+    check_entry( e[ 0 ], { 0x1234, 0, 0, 1 } );
+    check_entry( e[ 1 ], { 5, 1, 3, 2 } );
+
+    e = entries( "<</Size 3/W [1 3 1]/Index [7 1]>>", std::string( "\x01\x12\x34\x56\x02", 5 ) );
+    ASSERT_EQ( e.size( ), 1 );
+    check_entry( e[ 0 ], { 0x123456, 7, 2, 1 } );
+
+    e = entries( "<</Size 1/W [1 4 2]>>", std::string( "\x01\x12\x34\x56\x78\x01\x02", 7 ) );
+    ASSERT_EQ( e.size( ), 1 );
+    check_entry( e[ 0 ], { 0x12345678, 0, 0x0102, 1 } );
+
+    // a missing type field defaults to 1
+    e = entries( "<</Size 2/W [0 2 0]/Index [3 2]>>", std::string( "\x00\x10\x01\x00", 4 ) );
+    ASSERT_EQ( e.size( ), 2 );
+    check_entry( e[ 0 ], { 0x10, 3, 0, 1 } );
+    check_entry( e[ 1 ], { 0x100, 4, 0, 1 } );
+
+    EXPECT_THROW( entries( "<</Size 2/W [1 2 1]>>", std::string( "\x01\x12\x34\x00", 4 ) ), std::runtime_error );
+    EXPECT_THROW( entries( "<</Size 1/W [1 9 1]>>", std::string( 11, '\0' ) ), std::runtime_error );
+
+    // wide fields are accepted as long as the values fit the entry
+    e = entries( "<</Size 1/W [1 8 2]>>", std::string( "\x01\x00\x00\x00\x00\x12\x34\x56\x78\x00\x01", 11 ) );
+    ASSERT_EQ( e.size( ), 1 );
+    check_entry( e[ 0 ], { 0x12345678, 0, 1, 1 } );
+    EXPECT_THROW( entries( "<</Size 1/W [1 8 2]>>", std::string( "\x01\x00\x00\x00\x01\x00\x00\x00\x00\x00\x00", 11 ) ),
+                  std::runtime_error );
+    EXPECT_THROW( entries( "<</Size 1/W [1 2 5]>>", std::string( "\x01\x00\x10\x01\x00\x00\x00\x00", 8 ) ),
+                  std::runtime_error );
+
+    // unknown types are stored as free entries, so they are not mistaken for missing ones
+    e = entries( "<</Size 2/W [1 2 1]>>", std::string( "\xFF\x00\x10\x00\x03\x00\x20\x00", 8 ) );
+    ASSERT_EQ( e.size( ), 2 );
+    XRefTable table;
+    for ( const auto &entry : e )
+        table.set_entry( entry );
+    EXPECT_EQ( table.size( ), 2 );
+    ASSERT_NE( table.get_entry( 0 ), nullptr );
+    EXPECT_EQ( table.get_entry( 0 )->type, 0 );
+    ASSERT_NE( table.get_entry( 1 ), nullptr );
+    EXPECT_EQ( table.get_entry( 1 )->type, 0 );
+}
+
+TEST( ParseWithArena, BasicAssertions )
+{
+    std::shared_ptr<PDFBaseObject> item;
+    {
+        PDFObjectParser parser( "<</A [1 2.5 /N (s) true null 3 0 R]>>" );
+        parser.set_arena( std::make_shared<PDFObjectArena>( ) );
+        auto dict = parser.parse_object( nullptr, false )->to<PDFDictionary>( );
+        ASSERT_NE( dict, nullptr );
+        auto arr = dict->get<PDFArray>( "A", false );
+        ASSERT_NE( arr, nullptr );
+        EXPECT_EQ( arr->value.size( ), 7 );
+        item = arr->value[ 3 ];
+    }
+    // objects keep the arena alive after the parser is gone
+    ASSERT_NE( item->to<PDFString>( ), nullptr );
+    EXPECT_EQ( item->to<PDFString>( )->get_string( ), "s" );
 }
\ No newline at end of file
@@ -1,6 +1,14 @@
+#include <vrock/pdf/PDFDocument.hpp>
+#include <vrock/pdf/parser/InputSource.hpp>
+#include <vrock/pdf/parser/PDFObjectParser.hpp>
+#include <vrock/pdf/structure/PDFFilters.hpp>
+
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <filesystem>
 #include <iostream>
+#include <set>
 
 using namespace vrock::pdf;
 
@@ -16,4 +24,112 @@ TEST( ExternalImage, BasicAssertions )
     EXPECT_EQ( img[ 0 ]->rotation, 0.0 );
     EXPECT_EQ( img[ 0 ]->shear, 0.0 );
     // TODO: Add test for rotated and shear image
+}
+
+namespace
+{
+    auto find_jpeg( const std::shared_ptr<PDFBaseObject> &obj, std::set<PDFBaseObject *> &visited )
+        -> std::shared_ptr<PDFStream>
+    {
+        if ( obj == nullptr || !visited.insert( obj.get( ) ).second )
+            return nullptr;
+        if ( auto stream = obj->to<PDFStream>( ) )
+        {
+            if ( !stream->filters.empty( ) && stream->filters.back( ) == "DCTDecode" )
+                return stream;
+            return find_jpeg( stream->dict, visited );
+        }
+        if ( auto dict = obj->to<PDFDictionary>( ) )
+            for ( const auto &[ key, value ] : dict->dict )
+                if ( auto stream = find_jpeg( dict->get( key->name ), visited ) )
+                    return stream;
+        if ( auto arr = obj->to<PDFArray>( ) )
+            for ( std::size_t i = 0; i < arr->value.size( ); ++i )
+                if ( auto stream = find_jpeg( arr->get( i ), visited ) )
+                    return stream;
+        return nullptr;
+    }
+
+    // the only JPEG of the document, which has an Adobe marker and three components
+    auto read_jpeg( ) -> std::string
+    {
+        auto doc = PDFDocument( "pdfs/with_update_sections.pdf" );
+        std::set<PDFBaseObject *> visited;
+        auto stream = find_jpeg( doc.get_trailer( ), visited );
+        if ( stream == nullptr )
+            return { };
+        return std::string( stream->raw( ) );
+    }
+
+    // removes the APP14 segment written by Adobe
+    auto strip_adobe_marker( const std::string &jpeg ) -> std::string
+    {
+        std::size_t pos = 2;
+        while ( pos + 4 <= jpeg.size( ) && static_cast<std::uint8_t>( jpeg[ pos ] ) == 0xFF )
+        {
+            auto marker = static_cast<std::uint8_t>( jpeg[ pos + 1 ] );
+            auto length = static_cast<std::size_t>( static_cast<std::uint8_t>( jpeg[ pos + 2 ] ) ) << 8 |
+                          static_cast<std::uint8_t>( jpeg[ pos + 3 ] );
+            if ( marker == 0xEE )
+                return jpeg.substr( 0, pos ) + jpeg.substr( pos + 2 + length );
+            // the entropy coded data follows the start of scan
+            if ( marker == 0xDA )
+                break;
+            pos += 2 + length;
+        }
+        return jpeg;
+    }
+} // namespace
+
+TEST( DCTDecode, BasicAssertions )
+{
+    auto jpeg = read_jpeg( );
+    ASSERT_FALSE( jpeg.empty( ) );
+    auto filter = PDFDCTFilter( );
+    auto params = std::make_shared<PDFDictionary>( );
+    auto decoded = filter.decode( jpeg, params );
+    EXPECT_EQ( decoded.size( ), 80 * 71 * 3 );
+
+    // without the Adobe marker ColorTransform decides if the samples are converted from YCbCr
+    auto stripped = strip_adobe_marker( jpeg );
+    ASSERT_LT( stripped.size( ), jpeg.size( ) );
+    params->set( "ColorTransform", std::make_shared<PDFInteger>( 1 ) );
+    EXPECT_EQ( filter.decode( stripped, params ), decoded );
+    params->set( "ColorTransform", std::make_shared<PDFInteger>( 0 ) );
+    auto untransformed = filter.decode( stripped, params );
+    EXPECT_EQ( untransformed.size( ), decoded.size( ) );
+    EXPECT_NE( untransformed, decoded );
+    // the marker takes precedence over ColorTransform
+    EXPECT_EQ( filter.decode( jpeg, params ), decoded );
+
+    EXPECT_THROW( filter.decode( "not a jpeg", params ), std::runtime_error );
+    EXPECT_THROW( filter.decode( jpeg.substr( 0, 100 ), params ), std::runtime_error );
+}
+
+TEST( ImagePassthrough, BasicAssertions )
+{
+    auto doc = PDFDocument( "pdfs/with_update_sections.pdf" );
+    std::shared_ptr<PDFImage> jpeg_image;
+    for ( const auto &page : doc.get_pages( ) )
+        for ( const auto &image : page->get_images( ) )
+            if ( image->image && image->image->is_jpeg( ) )
+                jpeg_image = image->image;
+    ASSERT_NE( jpeg_image, nullptr );
+
+    // the JPEG is written as it is stored in the document
+    auto path = std::filesystem::temp_directory_path( ) / "vrock_image.jpg";
+    jpeg_image->save( path.string( ), ImageSaveFormat::jpeg );
+    EXPECT_EQ( read_file( path )->view( ), read_jpeg( ) );
+    std::filesystem::remove( path );
+
+    EXPECT_EQ( jpeg_image->as_rgb( ).size( ), 80 * 71 * 3 );
+}
+
+TEST( JPXImage, BasicAssertions )
+{
+    PDFObjectParser parser( "<</Filter/JPXDecode/Width 1/Height 1/Length 4>>stream\nabcd\nendstream" );
+    auto stream = parser.parse_object( nullptr, false )->to<PDFStream>( );
+    ASSERT_NE( stream, nullptr );
+    // the encoded bytes must not be mistaken for pixels
+    EXPECT_THROW( PDFImage( stream ).as_rgb( ), std::runtime_error );
 }
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include <vrock/pdf/structure/PDFFilters.hpp>
+#include <vrock/pdf/structure/PDFObjects.hpp>
+#include <vrock/utils/SpanHelpers.hpp>
+#include <vrock/utils/ThreadPool.hpp>
 
 #include <gtest/gtest.h>
 
@@ -11,4 +14,103 @@ TEST( ASCIIHexFilter, BasicAssertions )
     auto encoded = filter->encode( "Test", nullptr );
     EXPECT_EQ( encoded, "54657374>" );
     EXPECT_EQ( filter->decode( encoded, nullptr ), "Test" );
+}
+
+// zlib compressed "vrock.pdf " repeated 10000 times
+static const auto flate_data = vrock::utils::from_hex_string<std::string>(
+    "78daedc6310d00200c00302b28c0148487838563fa6763477b35ff5b77c63e23cd" + std::string( 384, 'c' ) +
+    "acd90a84c89e32" );
+
+static auto flate_expected( ) -> std::string
+{
+    std::string expected;
+    for ( int i = 0; i < 10000; ++i )
+        expected += "vrock.pdf ";
+    return expected;
+}
+
+TEST( FlateFilter, BasicAssertions )
+{
+    auto filter = std::make_shared<PDFFlateFilter>( );
+    auto params = std::make_shared<PDFDictionary>( );
+    auto expected = flate_expected( );
+
+    EXPECT_EQ( filter->decode( flate_data, params ), expected );
+    // exact, too small and too large size hints
+    EXPECT_EQ( filter->decode( flate_data, params, expected.size( ) ), expected );
+    EXPECT_EQ( filter->decode( flate_data, params, 10 ), expected );
+    EXPECT_EQ( filter->decode( flate_data, params, 1ull << 40 ), expected );
+    EXPECT_THROW( filter->decode( flate_data.substr( 0, 40 ), params ), std::runtime_error );
+}
+
+TEST( FlateFilterStreaming, BasicAssertions )
+{
+    auto filter = std::make_shared<PDFFlateFilter>( );
+    auto params = std::make_shared<PDFDictionary>( );
+
+    std::string decoded;
+    int chunks = 0;
+    filter->decode_to( flate_data, params, [ & ]( in_data_t chunk ) {
+        decoded.append( chunk );
+        ++chunks;
+    } );
+    EXPECT_EQ( decoded, flate_expected( ) );
+    EXPECT_GT( chunks, 1 );
+}
+
+TEST( FlateFilterParallel, BasicAssertions )
+{
+    // text that repeats with long distances, so matches cross the block boundaries
+    std::string data;
+    std::uint32_t state = 1;
+    while ( data.size( ) < 3 * parallel_flate_threshold )
+    {
+        state = state * 1664525u + 1013904223u;
+        data += "object " + std::to_string( state % 4096 ) + " 0 R /Length " + std::to_string( state >> 20 );
+        data += '\n';
+    }
+
+    auto params = std::make_shared<PDFDictionary>( );
+    auto serial = PDFFlateFilter( 6, SIZE_MAX ).encode( data, nullptr );
+    auto pool = std::make_shared<vrock::utils::ThreadPool>( 4 );
+    auto parallel = PDFFlateFilter( 6, parallel_flate_threshold, pool ).encode( data, nullptr );
+    // without a pool the data is compressed serially
+    EXPECT_EQ( PDFFlateFilter( 6 ).encode( data, nullptr ), serial );
+    EXPECT_EQ( PDFFlateFilter( ).decode( parallel, params ), data );
+    EXPECT_EQ( PDFFlateFilter( ).decode( serial, params ), data );
+    // priming every block with the previous window keeps the overhead small
+    EXPECT_LT( parallel.size( ), serial.size( ) + serial.size( ) / 50 );
+
+    // a size that is not a multiple of the block size and the smallest possible input
+    auto odd = data.substr( 0, parallel_flate_threshold + 12345 );
+    EXPECT_EQ( PDFFlateFilter( ).decode( PDFFlateFilter( 9, 1, pool ).encode( odd, nullptr ), params ), odd );
+    EXPECT_EQ( PDFFlateFilter( ).decode( PDFFlateFilter( 1, 0, pool ).encode( "", nullptr ), params ), "" );
+}
+
+TEST( PNGPredictor, BasicAssertions )
+{
+    using vrock::utils::from_hex_string;
+    // 3 columns rgb, rows using None, Sub, Up, Average, Paeth, Paeth
+    auto rgb = from_hex_string<std::string>(
+        "00a54dca182530bb1d6d01132cdec3f79d58b6a3022c4641f5f6f6e96b7603b7102dcd2bde066ecd044ad52ddebc37510e19047961f3"
+        "7e4ff981862c" );
+    auto rgb_expected = from_hex_string<std::string>(
+        "a54dca182530bb1d6d132cded6237b2ed91e3f721fcb1971174494d6493c9d5c3460be31201e69fedaa0eee8b9997f5c7c2999fdafe5" );
+    EXPECT_EQ( predict_png( rgb, 3, 3, 8 ), rgb_expected );
+
+    // 10 columns with 1 bit per component, rows using Sub, Up, Average, Paeth, None
+    auto bits = from_hex_string<std::string>( "01939202a9b103361a04f94b00d714" );
+    auto bits_expected = from_hex_string<std::string>( "93253cd654af4dfad714" );
+    EXPECT_EQ( predict_png( bits, 10, 1, 1 ), bits_expected );
+
+    // incomplete rows are dropped
+    EXPECT_EQ( predict_png( bits.substr( 0, 4 ), 10, 1, 1 ), bits_expected.substr( 0, 2 ) );
+
+    EXPECT_EQ( predict_png( "", 3, 3, 8 ), "" );
+    EXPECT_THROW( predict_png( rgb, 0, 3, 8 ), std::runtime_error );
+    EXPECT_THROW( predict_png( rgb, -3, 3, 8 ), std::runtime_error );
+    EXPECT_THROW( predict_png( rgb, 3, 0, 8 ), std::runtime_error );
+    EXPECT_THROW( predict_png( rgb, 3, 3, 0 ), std::runtime_error );
+    EXPECT_THROW( predict_png( rgb, 0x7FFFFFFF, 3, 8 ), std::runtime_error );
+    EXPECT_THROW( predict_png( rgb, 0x7FFFFFFF, 0x7FFFFFFF, 16 ), std::runtime_error );
 }
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include <vrock/pdf/structure/PDFNames.hpp>
+#include <vrock/pdf/structure/PDFObjects.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace vrock::pdf;
+
+TEST( NameIds, BasicAssertions )
+{
+    static_assert( names::well_known[ names::Type ] == "Type" );
+    static_assert( names::find( "Kids" ) == names::Kids );
+    EXPECT_EQ( names::find( "NotAWellKnownName" ), 0 );
+    EXPECT_EQ( names::find( "" ), 0 );
+
+    EXPECT_EQ( PDFName( "Type" ).id, names::Type );
+    EXPECT_EQ( PDFName( "Custom" ).id, 0 );
+    // escaped names get the id of the decoded name
+    EXPECT_EQ( PDFName( "T#79pe", true ).id, names::Type );
+}
+
+TEST( DictionaryNameLookup, BasicAssertions )
+{
+    auto dict = std::make_shared<PDFDictionary>( );
+    dict->set( "Type", std::make_shared<PDFName>( "Page" ) );
+    dict->set( "Custom", std::make_shared<PDFInteger>( 42 ) );
+
+    EXPECT_TRUE( dict->has( names::Type ) );
+    EXPECT_TRUE( dict->has( "Type" ) );
+    EXPECT_FALSE( dict->has( names::Kids ) );
+    EXPECT_TRUE( dict->has( std::string( "Custom" ) ) );
+    EXPECT_FALSE( dict->has( "custom" ) );
+
+    auto type = dict->get<PDFName>( names::Type );
+    ASSERT_NE( type, nullptr );
+    EXPECT_EQ( type->id, names::Page );
+    EXPECT_EQ( dict->get<PDFInteger>( "Custom" )->value, 42 );
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include <vrock/pdf/PDFDocument.hpp>
+#include <vrock/pdf/parser/PDFObjectParser.hpp>
+#include <vrock/pdf/structure/PDFObjectCache.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace vrock::pdf;
+
+TEST( ObjectCacheEviction, BasicAssertions )
+{
+    auto str = std::make_shared<PDFByteString>( std::string( 100, 'a' ) );
+    auto size = estimate_size( str );
+    PDFObjectCache cache( { .max_size = 2 * size } );
+
+    cache.insert( std::make_shared<PDFRef>( 1, 0, 1 ), std::make_shared<PDFByteString>( std::string( 100, 'a' ) ) );
+    cache.insert( std::make_shared<PDFRef>( 2, 0, 1 ), std::make_shared<PDFByteString>( std::string( 100, 'b' ) ) );
+    EXPECT_EQ( cache.size( ), 2 );
+    EXPECT_EQ( cache.byte_size( ), 2 * size );
+
+    // touch 1 so 2 becomes the least recently used object
+    EXPECT_NE( cache.get( std::make_shared<PDFRef>( 1, 0, 1 ) ), nullptr );
+    cache.insert( std::make_shared<PDFRef>( 3, 0, 1 ), std::make_shared<PDFByteString>( std::string( 100, 'c' ) ) );
+    EXPECT_EQ( cache.size( ), 2 );
+    EXPECT_EQ( cache.get( std::make_shared<PDFRef>( 2, 0, 1 ) ), nullptr );
+    EXPECT_NE( cache.get( std::make_shared<PDFRef>( 1, 0, 1 ) ), nullptr );
+    EXPECT_NE( cache.get( std::make_shared<PDFRef>( 3, 0, 1 ) ), nullptr );
+}
+
+TEST( ObjectCacheStreamSize, BasicAssertions )
+{
+    auto content = std::string( 1000, 'a' );
+    PDFObjectParser parser( "<</Length 1000>>stream\n" + content + "\nendstream" );
+    auto stream = parser.parse_dictionary_or_stream( nullptr, false )->to<PDFStream>( );
+    ASSERT_NE( stream, nullptr );
+
+    // the encoded data is a view into the input and not counted
+    auto size = estimate_size( stream );
+    EXPECT_LT( size, content.size( ) );
+    EXPECT_EQ( stream->decoded( ), content );
+    EXPECT_EQ( estimate_size( stream ), size + content.size( ) );
+    stream->release( );
+    EXPECT_EQ( estimate_size( stream ), size );
+}
+
+TEST( ObjectCachePinning, BasicAssertions )
+{
+    auto size = estimate_size( std::make_shared<PDFByteString>( std::string( 100, 'a' ) ) );
+    PDFObjectCache cache( { .max_size = size } );
+
+    cache.insert( std::make_shared<PDFRef>( 1, 0, 1 ), std::make_shared<PDFByteString>( std::string( 100, 'a' ) ),
+                  true );
+    cache.insert( std::make_shared<PDFRef>( 2, 0, 1 ), std::make_shared<PDFByteString>( std::string( 100, 'b' ) ) );
+    cache.insert( std::make_shared<PDFRef>( 3, 0, 1 ), std::make_shared<PDFByteString>( std::string( 100, 'c' ) ) );
+    EXPECT_NE( cache.get( std::make_shared<PDFRef>( 1, 0, 1 ) ), nullptr );
+    EXPECT_EQ( cache.get( std::make_shared<PDFRef>( 2, 0, 1 ) ), nullptr );
+    EXPECT_EQ( cache.byte_size( ), size );
+
+    auto dict = std::make_shared<PDFDictionary>( );
+    dict->set( "Type", std::make_shared<PDFName>( "Pages" ) );
+    cache.insert( std::make_shared<PDFRef>( 4, 0, 1 ), dict );
+    cache.insert( std::make_shared<PDFRef>( 5, 0, 1 ), std::make_shared<PDFByteString>( std::string( 100, 'd' ) ) );
+    EXPECT_EQ( cache.get( std::make_shared<PDFRef>( 4, 0, 1 ) ), dict );
+}
+
+TEST( ObjectCacheKeepsIdentity, BasicAssertions )
+{
+    auto size = estimate_size( std::make_shared<PDFByteString>( std::string( 100, 'a' ) ) );
+    PDFObjectCache cache( { .max_size = size } );
+
+    auto held = std::make_shared<PDFByteString>( std::string( 100, 'a' ) );
+    cache.insert( std::make_shared<PDFRef>( 1, 0, 1 ), held );
+    cache.insert( std::make_shared<PDFRef>( 2, 0, 1 ), std::make_shared<PDFByteString>( std::string( 100, 'b' ) ) );
+    EXPECT_EQ( cache.contains( std::make_shared<PDFRef>( 1, 0, 1 ) ), false );
+    // still referenced, so the evicted object is handed out again
+    EXPECT_EQ( cache.get( std::make_shared<PDFRef>( 1, 0, 1 ) ), held );
+}
+
+TEST( ObjectCacheDocument, BasicAssertions )
+{
+    auto doc = PDFDocument( "pdfs/with_update_sections.pdf" );
+    doc.set_cache_policy( { .max_size = 1024 } );
+    auto count = doc.get_page_count( );
+    for ( std::int32_t i = 0; i < count; ++i )
+        EXPECT_NE( doc.get_page( i ), nullptr );
+}
+
+TEST( PrefetchObjectStreams, BasicAssertions )
+{
+    vrock::utils::ThreadPool pool( 4 );
+    auto plain = PDFDocument( "pdfs/sample_form.pdf" );
+    auto prefetched = PDFDocument( "pdfs/sample_form.pdf" );
+    EXPECT_GT( prefetched.prefetch_object_streams( pool ), 0 );
+    // the streams are cached now, so a second call only hits the cache
+    EXPECT_GT( prefetched.prefetch_object_streams( pool ), 0 );
+
+    auto pages = plain.get_pages( );
+    auto prefetched_pages = prefetched.get_pages( );
+    ASSERT_EQ( pages.size( ), prefetched_pages.size( ) );
+    for ( std::size_t i = 0; i < pages.size( ); ++i )
+    {
+        auto expected = pages[ i ]->get_text( );
+        auto text = prefetched_pages[ i ]->get_text( );
+        ASSERT_EQ( text.size( ), expected.size( ) );
+        for ( std::size_t j = 0; j < text.size( ); ++j )
+            EXPECT_EQ( text[ j ]->text, expected[ j ]->text );
+    }
+}
\ No newline at end of file
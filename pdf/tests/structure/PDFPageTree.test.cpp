@@ -0,0 +1,64 @@
+#include <vrock/pdf/PDFDocument.hpp>
+#include <vrock/pdf/parser/ContentStreamParser.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace vrock::pdf;
+
+TEST( PageTreeParallel, BasicAssertions )
+{
+    std::vector<std::string> files = { "pdfs/simple.pdf", "pdfs/sample_form.pdf", "pdfs/with_update_sections.pdf",
+                                       "pdfs/Encrypted/R4_O_AES.pdf" };
+    vrock::utils::ThreadPool pool( 4 );
+    for ( const auto &file : files )
+    {
+        auto sequential = PDFDocument( file );
+        // the cross-reference tables are decoded on the pool as well
+        auto parallel = PDFDocument( file, pool );
+
+        auto pages = sequential.get_pages( );
+        auto parallel_pages = parallel.get_pages_parallel( pool );
+        ASSERT_EQ( pages.size( ), parallel_pages.size( ) );
+
+        auto text = parallel.extract_text_parallel( pool );
+        ASSERT_EQ( text.size( ), pages.size( ) );
+        for ( std::size_t i = 0; i < pages.size( ); ++i )
+        {
+            ASSERT_NE( parallel_pages[ i ], nullptr );
+            EXPECT_EQ( parallel_pages[ i ]->rotation, pages[ i ]->rotation );
+            auto expected = pages[ i ]->get_text( );
+            ASSERT_EQ( text[ i ].size( ), expected.size( ) );
+            for ( std::size_t j = 0; j < expected.size( ); ++j )
+                EXPECT_EQ( text[ i ][ j ]->text, expected[ j ]->text );
+        }
+    }
+}
+
+TEST( PageProgramCache, BasicAssertions )
+{
+    auto doc = PDFDocument( "pdfs/sample_form.pdf" );
+    auto page = doc.get_page( 0 );
+    ASSERT_NE( page, nullptr );
+    EXPECT_FALSE( page->get_text( ).empty( ) );
+    // the program the text was extracted from is kept for later use
+    auto program = page->get_program( );
+    ASSERT_NE( program, nullptr );
+    EXPECT_FALSE( program->instructions.empty( ) );
+    EXPECT_EQ( page->get_program( ), program );
+}
+
+TEST( PageTextPrefix, BasicAssertions )
+{
+    auto doc = PDFDocument( "pdfs/sample_form.pdf" );
+    for ( const auto &page : doc.get_pages( ) )
+    {
+        auto full = page->get_text( );
+        auto none = page->get_text( 0 );
+        auto prefix = page->get_text( 1 );
+        // the limit is checked after every operator, so at most the first operator runs
+        EXPECT_LE( none.size( ), 1 );
+        EXPECT_LE( prefix.size( ), full.size( ) );
+        for ( std::size_t i = 0; i < prefix.size( ); ++i )
+            EXPECT_EQ( prefix[ i ]->text, full[ i ]->text );
+    }
+}
\ No newline at end of file
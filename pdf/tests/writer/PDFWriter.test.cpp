@@ -0,0 +1,235 @@
+#include <vrock/pdf/PDFDocument.hpp>
+#include <vrock/pdf/parser/PDFObjectParser.hpp>
+
+#include <gtest/gtest.h>
+
+#include <format>
+#include <fstream>
+
+using namespace vrock::pdf;
+
+namespace
+{
+    auto expect_same_text( PDFDocument &expected, PDFDocument &actual ) -> void
+    {
+        auto pages = expected.get_pages( );
+        auto written_pages = actual.get_pages( );
+        ASSERT_EQ( pages.size( ), written_pages.size( ) );
+        for ( std::size_t i = 0; i < pages.size( ); ++i )
+        {
+            EXPECT_EQ( written_pages[ i ]->rotation, pages[ i ]->rotation );
+            auto text = pages[ i ]->get_text( );
+            auto written_text = written_pages[ i ]->get_text( );
+            ASSERT_EQ( written_text.size( ), text.size( ) );
+            for ( std::size_t j = 0; j < text.size( ); ++j )
+                EXPECT_EQ( written_text[ j ]->text, text[ j ]->text );
+        }
+    }
+} // namespace
+
+TEST( WriteValue, BasicAssertions )
+{
+    PDFObjectParser parser( "<</A#20B [1 -2.5 (a\\)b\\\\) true null 3 0 R] /S <00FF10>>>" );
+    auto dict = parser.parse_dictionary( nullptr, false );
+
+    PDFWriter writer( std::make_shared<PDFContext>( nullptr ) );
+    data_t out;
+    writer.write_value( dict, out );
+
+    PDFObjectParser reparser( out );
+    auto written = reparser.parse_dictionary( nullptr, false );
+    auto arr = written->get<PDFArray>( "A B", false );
+    ASSERT_NE( arr, nullptr );
+    ASSERT_EQ( arr->value.size( ), 6 );
+    EXPECT_EQ( arr->get<PDFInteger>( 0, false )->value, 1 );
+    EXPECT_EQ( arr->get<PDFReal>( 1, false )->value, -2.5 );
+    EXPECT_EQ( arr->get<PDFString>( 2, false )->get_string( ), "a)b\\" );
+    EXPECT_EQ( arr->get<PDFBool>( 3, false )->value, true );
+    EXPECT_EQ( arr->get( 4, false )->type, PDFObjectType::Null );
+    // references are renumbered in the order they are written
+    EXPECT_EQ( arr->get<PDFRef>( 5, false )->object_number, 1 );
+    EXPECT_EQ( written->get<PDFString>( "S", false )->get_data( ), std::string( "\x00\xFF\x10", 3 ) );
+}
+
+TEST( SaveDocument, BasicAssertions )
+{
+    std::vector<std::string> files = { "pdfs/simple.pdf", "pdfs/sample_form.pdf", "pdfs/with_update_sections.pdf",
+                                       "pdfs/Encrypted/R4_O_AES.pdf" };
+    for ( const auto &file : files )
+    {
+        for ( auto object_streams : { true, false } )
+        {
+            auto path = std::filesystem::temp_directory_path( ) / "vrock_written.pdf";
+            auto doc = PDFDocument( file );
+            doc.set_write_options( { .compression_level = 9, .object_streams = object_streams } );
+            doc.save( path );
+
+            auto written = PDFDocument( path );
+            EXPECT_EQ( written.get_page_count( ), doc.get_page_count( ) );
+            expect_same_text( doc, written );
+            std::filesystem::remove( path );
+        }
+    }
+}
+
+TEST( SaveOverwrite, BasicAssertions )
+{
+    auto path = std::filesystem::temp_directory_path( ) / "vrock_overwrite.pdf";
+    std::filesystem::copy_file( "pdfs/sample_form.pdf", path, std::filesystem::copy_options::overwrite_existing );
+    auto expected = PDFDocument( "pdfs/sample_form.pdf" );
+    {
+        auto doc = PDFDocument( path, PDFOpenMode::MemoryMapped );
+        doc.save( );
+        // the source is still readable after it was replaced
+        expect_same_text( expected, doc );
+        // the object numbers of the replaced file are gone, so an update section would not match it
+        EXPECT_THROW( doc.save( PDFSaveMode::Append ), std::runtime_error );
+    }
+    auto written = PDFDocument( path );
+    expect_same_text( expected, written );
+    std::filesystem::remove( path );
+
+    // a document without content is not saved and leaves no temporary file behind
+    auto empty = std::filesystem::temp_directory_path( ) / "vrock_empty.pdf";
+    EXPECT_THROW( PDFDocument( ).save( empty ), std::runtime_error );
+    EXPECT_FALSE( std::filesystem::exists( empty ) );
+    EXPECT_FALSE( std::filesystem::exists( std::filesystem::path( empty ) += ".tmp" ) );
+}
+
+TEST( SaveAppend, BasicAssertions )
+{
+    for ( const auto &file : { "pdfs/with_update_sections.pdf", "pdfs/sample_form.pdf" } )
+    {
+        auto path = std::filesystem::temp_directory_path( ) / "vrock_append.pdf";
+        std::filesystem::copy_file( file, path, std::filesystem::copy_options::overwrite_existing );
+        auto original_size = std::filesystem::file_size( path );
+        auto expected = PDFDocument( file );
+        {
+            auto doc = PDFDocument( path );
+            auto root = doc.get_trailer( )->get<PDFDictionary>( names::Root );
+            ASSERT_NE( root, nullptr );
+            root->set( "VrockValue", std::make_shared<PDFInteger>( 42 ) );
+            root->set( "VrockObject", doc.add_object( std::make_shared<PDFUTF8String>( "added" ) ) );
+            doc.save( PDFSaveMode::Append );
+
+            // only the catalog, the new object and a cross-reference section are appended
+            auto size = std::filesystem::file_size( path );
+            EXPECT_GT( size, original_size );
+            EXPECT_LT( size - original_size, original_size / 8 );
+            auto original = read_file( file );
+            auto appended = read_file( path );
+            EXPECT_EQ( appended->view( ).substr( 0, original_size ), original->view( ) );
+
+            root->set( "VrockValue", std::make_shared<PDFInteger>( 43 ) );
+            doc.save( PDFSaveMode::Append );
+        }
+
+        auto written = PDFDocument( path );
+        auto root = written.get_trailer( )->get<PDFDictionary>( names::Root );
+        ASSERT_NE( root, nullptr );
+        ASSERT_NE( root->get<PDFInteger>( "VrockValue" ), nullptr );
+        EXPECT_EQ( root->get<PDFInteger>( "VrockValue" )->value, 43 );
+        ASSERT_NE( root->get<PDFString>( "VrockObject" ), nullptr );
+        EXPECT_EQ( root->get<PDFString>( "VrockObject" )->get_string( ), "added" );
+        expect_same_text( expected, written );
+        std::filesystem::remove( path );
+    }
+
+    // an update saved to a copy does not count as a revision of the source
+    {
+        auto path = std::filesystem::temp_directory_path( ) / "vrock_append_source.pdf";
+        auto copy = std::filesystem::temp_directory_path( ) / "vrock_append_copy.pdf";
+        std::filesystem::copy_file( "pdfs/sample_form.pdf", path, std::filesystem::copy_options::overwrite_existing );
+        {
+            auto doc = PDFDocument( path );
+            auto root = doc.get_trailer( )->get<PDFDictionary>( names::Root );
+            ASSERT_NE( root, nullptr );
+            root->set( "VrockValue", std::make_shared<PDFInteger>( 42 ) );
+            doc.save( copy, PDFSaveMode::Append );
+            doc.save( PDFSaveMode::Append );
+        }
+        for ( const auto &file : { path, copy } )
+        {
+            auto written = PDFDocument( file );
+            auto root = written.get_trailer( )->get<PDFDictionary>( names::Root );
+            ASSERT_NE( root, nullptr );
+            ASSERT_NE( root->get<PDFInteger>( "VrockValue" ), nullptr );
+            EXPECT_EQ( root->get<PDFInteger>( "VrockValue" )->value, 42 );
+        }
+        std::filesystem::remove( path );
+        std::filesystem::remove( copy );
+    }
+
+    // a document that was not read from a file has no revision to append to
+    auto path = std::filesystem::temp_directory_path( ) / "vrock_append_new.pdf";
+    EXPECT_THROW( PDFDocument( ).save( path, PDFSaveMode::Append ), std::runtime_error );
+    EXPECT_FALSE( std::filesystem::exists( path ) );
+}
+
+TEST( StreamingWriter, BasicAssertions )
+{
+    auto path = std::filesystem::temp_directory_path( ) / "vrock_streamed.pdf";
+    constexpr std::size_t page_count = 300;
+    {
+        std::ofstream file( path, std::ofstream::binary | std::ofstream::trunc );
+        PDFWriter writer( file, { .objects_per_stream = 16 } );
+        writer.begin( );
+        EXPECT_THROW( writer.write( ), std::runtime_error );
+
+        // the page tree is written last, when all kids are known
+        auto pages_ref = writer.reserve( );
+        auto font = std::make_shared<PDFDictionary>( );
+        font->set( "Type", std::make_shared<PDFName>( "Font" ) );
+        font->set( "Subtype", std::make_shared<PDFName>( "Type1" ) );
+        font->set( "BaseFont", std::make_shared<PDFName>( "Helvetica" ) );
+        auto font_ref = writer.add_object( font );
+
+        auto kids = std::make_shared<PDFArray>( nullptr );
+        for ( std::size_t i = 0; i < page_count; ++i )
+        {
+            auto content = writer.add_stream( std::make_shared<PDFDictionary>( ), [ & ]( const consumer_t &consumer ) {
+                consumer( "BT /F1 12 Tf 72 720 Td " );
+                consumer( std::format( "(Page {}) Tj ET", i + 1 ) );
+            } );
+            auto fonts = std::make_shared<PDFDictionary>( );
+            fonts->set( "F1", font_ref );
+            auto resources = std::make_shared<PDFDictionary>( );
+            resources->set( "Font", fonts );
+            auto page = std::make_shared<PDFDictionary>( );
+            page->set( "Type", std::make_shared<PDFName>( "Page" ) );
+            page->set( "Parent", pages_ref );
+            page->set( "Resources", resources );
+            page->set( "Contents", content );
+            kids->value.push_back( writer.add_object( page ) );
+        }
+
+        auto pages = std::make_shared<PDFDictionary>( );
+        pages->set( "Type", std::make_shared<PDFName>( "Pages" ) );
+        pages->set( "Kids", kids );
+        pages->set( "Count", std::make_shared<PDFInteger>( static_cast<std::int32_t>( page_count ) ) );
+        auto media_box = std::make_shared<PDFArray>( nullptr );
+        for ( auto v : { 0, 0, 612, 792 } )
+            media_box->value.push_back( std::make_shared<PDFInteger>( v ) );
+        pages->set( "MediaBox", media_box );
+        writer.add_object( pages, pages_ref );
+        EXPECT_THROW( writer.add_object( pages, pages_ref ), std::runtime_error );
+
+        auto catalog = std::make_shared<PDFDictionary>( );
+        catalog->set( "Type", std::make_shared<PDFName>( "Catalog" ) );
+        catalog->set( "Pages", pages_ref );
+        auto trailer = std::make_shared<PDFDictionary>( );
+        trailer->set( "Root", writer.add_object( catalog ) );
+        writer.finish( trailer );
+    }
+
+    auto doc = PDFDocument( path );
+    ASSERT_EQ( doc.get_page_count( ), static_cast<std::int32_t>( page_count ) );
+    auto pages = doc.get_pages( );
+    for ( auto i : { std::size_t( 0 ), page_count / 2, page_count - 1 } )
+    {
+        auto text = pages[ i ]->get_text( );
+        ASSERT_EQ( text.size( ), 1 );
+        EXPECT_EQ( text[ 0 ]->text, std::format( "Page {}", i + 1 ) );
+    }
+    std::filesystem::remove( path );
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <vrock/security.hpp>
+#include <vrock/utils.hpp>
+
+using namespace vrock::security;
+
+// hashes count messages of size bytes one by one and as a batch
+auto run( std::size_t size, std::size_t count ) -> void
+{
+    std::vector<std::vector<std::uint8_t>> buffers( count, std::vector<std::uint8_t>( size ) );
+    for ( std::size_t i = 0; i < count; i++ )
+        std::fill( buffers[ i ].begin( ), buffers[ i ].end( ), static_cast<std::uint8_t>( i ) );
+    std::vector<byte_span_t> data( buffers.begin( ), buffers.end( ) );
+    std::vector<std::uint8_t> out( count * digest_size( HashAlgorithm::SHA256 ) );
+
+    auto report = [ & ]( const std::string &name, std::uint64_t us ) {
+        us = std::max<std::uint64_t>( 1, us );
+        std::cout << name << " " << size << " B: " << count << " messages in " << us / 1000 << "ms, "
+                  << size * count / us << " MB/s, " << count * 1000000 / us << " messages/s" << std::endl;
+    };
+
+    vrock::utils::Timer timer;
+    std::size_t checksum = 0;
+    for ( auto &d : data )
+        checksum += sha256( d )[ 0 ];
+    report( "single", timer.elapsed<std::chrono::microseconds>( ) );
+
+    timer.reset( );
+    hash_batch( HashAlgorithm::SHA256, data, out );
+    report( "batch ", timer.elapsed<std::chrono::microseconds>( ) );
+
+    // keep the digests alive
+    if ( checksum == 1 && out[ 0 ] == 1 )
+        std::cout << checksum;
+}
+
+int main( int argc, char **argv )
+{
+    auto scale = argc > 1 ? std::atoi( argv[ 1 ] ) : 1;
+
+    run( 64, 1000000 * scale );
+    run( 1024, 100000 * scale );
+    run( 1024 * 1024, 100 * scale );
+
+    return 0;
+}
@@ -2,6 +2,8 @@
 
 #include "typedefs.hpp"
 
+#include <memory>
+
 namespace vrock::security
 {
     enum class Padding
@@ -163,6 +165,15 @@ namespace vrock::security
     auto decrypt_aes_cbc( string_view_t data, string_view_t key, string_view_t iv,
                           Padding padding = Padding::NoPadding ) -> return_string_t;
 
+    /**
+     * Decrypts the data with AES in CBC mode without copying it
+     *
+     * @param data data to decrypt, a multiple of the block size. it is overwritten with the decrypted data
+     * @param key key for the decryption
+     * @param iv initialization vector
+     */
+    auto decrypt_aes_cbc_in_place( byte_span_t data, byte_span_t key, byte_span_t iv ) -> void;
+
     /**
      * Encrypt the data with RC4 (unsafe)
      *
@@ -202,4 +213,73 @@ namespace vrock::security
      * @return Decrypted result
      */
     auto decrypt_rc4( string_view_t data, string_view_t key ) -> return_string_t;
+
+    /**
+     * Decrypts the data with RC4 (unsafe) without copying it, which is the same as encrypting it
+     *
+     * @param data data to decrypt, it is overwritten with the decrypted data
+     * @param key key for the decryption
+     */
+    auto decrypt_rc4_in_place( byte_span_t data, byte_span_t key ) -> void;
+
+    enum class CipherMode
+    {
+        AES_CBC,
+        AES_CTR,
+        AES_GCM,
+        RC4
+    };
+
+    enum class CipherDirection
+    {
+        Encrypt,
+        Decrypt
+    };
+
+    /**
+     * Encrypts or decrypts data chunk by chunk, so large inputs do not have to be kept in memory at once. CBC does
+     * not pad the data, every chunk has to be a multiple of the block size.
+     */
+    class CipherStream
+    {
+    public:
+        /**
+         * @param mode cipher and mode of operation
+         * @param direction whether the stream encrypts or decrypts
+         * @param key key for the cipher
+         * @param iv initialization vector, 16 bytes for CBC and CTR, ignored for RC4
+         */
+        CipherStream( CipherMode mode, CipherDirection direction, byte_span_t key, byte_span_t iv = { } );
+        ~CipherStream( );
+
+        CipherStream( CipherStream && ) noexcept;
+        auto operator=( CipherStream && ) noexcept -> CipherStream &;
+
+        /**
+         * Adds additional authentication data for GCM, it has to be added before any data is processed
+         *
+         * @param data additional authentication data
+         */
+        auto add_authentication_data( byte_span_t data ) -> void;
+
+        /**
+         * Encrypts or decrypts the next chunk
+         *
+         * @param in chunk to process
+         * @param out buffer of at least the size of in, it may be the same as in
+         */
+        auto process( byte_span_t in, byte_span_t out ) -> void;
+
+        /**
+         * Ends the message. For GCM the authentication tag is written to tag when encrypting and compared with tag
+         * when decrypting, a mismatch throws std::runtime_error. Other modes ignore tag.
+         *
+         * @param tag 16 byte authentication tag
+         */
+        auto finalize( byte_span_t tag = { } ) -> void;
+
+    private:
+        struct State;
+        std::unique_ptr<State> state;
+    };
 } // namespace vrock::security
\ No newline at end of file
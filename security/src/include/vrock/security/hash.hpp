@@ -1,12 +1,69 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <span>
 #include <vrock/utils/ByteArray.hpp>
 
 #include "typedefs.hpp"
 
 namespace vrock::security
 {
+    enum class HashAlgorithm
+    {
+        MD5,
+        SHA224,
+        SHA256,
+        SHA384,
+        SHA512
+    };
+
+    /**
+     * @brief size of a digest of the algorithm in bytes
+     */
+    auto digest_size( HashAlgorithm algorithm ) -> std::size_t;
+
+    /**
+     * @brief hashes every element of data and writes the digests one after another into out. a single hash state is
+     * reused for all elements and nothing is allocated, which is faster than hashing many small buffers one by one
+     * @param algorithm algorithm to use
+     * @param data buffers to hash
+     * @param out buffer of at least data.size( ) * digest_size( algorithm ) bytes
+     */
+    auto hash_batch( HashAlgorithm algorithm, std::span<const byte_span_t> data, byte_span_t out ) -> void;
+
+    /**
+     * @brief hashes data that is passed in chunks, e.g. while a file is read
+     */
+    class Hasher
+    {
+    public:
+        explicit Hasher( HashAlgorithm algorithm );
+        ~Hasher( );
+
+        Hasher( Hasher && ) noexcept;
+        auto operator=( Hasher && ) noexcept -> Hasher &;
+
+        /**
+         * @brief adds the next chunk to the hash
+         */
+        auto update( byte_span_t data ) -> void;
+        auto update( string_view_t data ) -> void;
+
+        /**
+         * @brief writes the digest of all chunks to out and restarts the hasher
+         * @param out buffer of at least digest_size( ) bytes
+         */
+        auto finalize( byte_span_t out ) -> void;
+        auto finalize( ) -> return_t;
+
+        [[nodiscard]] auto digest_size( ) const -> std::size_t;
+
+    private:
+        struct State;
+        std::unique_ptr<State> state;
+    };
+
     /**
      * @brief hashes the data using the MD5 algorithm
      * @param data data to hash
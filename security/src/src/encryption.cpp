@@ -137,7 +137,7 @@ namespace vrock::security
         CryptoPP::ECB_Mode<CryptoPP::AES>::Encryption e;
         e.SetKey( key.data( ), key.size( ) );
         return_t cipher;
-        CryptoPP::StringSource c( to_string( data ), true,
+        CryptoPP::StringSource c( data.data( ), data.size( ), true,
                                   new CryptoPP::StreamTransformationFilter( e, new CryptoPP::VectorSink( cipher ),
                                                                             convert_padding_scheme( padding ) ) );
 
@@ -149,7 +149,7 @@ namespace vrock::security
         CryptoPP::ECB_Mode<CryptoPP::AES>::Decryption d;
         d.SetKey( key.data( ), key.size( ) );
         return_t decrypted;
-        CryptoPP::StringSource s( to_string( data ), true,
+        CryptoPP::StringSource s( data.data( ), data.size( ), true,
                                   new CryptoPP::StreamTransformationFilter( d, new CryptoPP::VectorSink( decrypted ),
                                                                             convert_padding_scheme( padding ) ) );
         return decrypted;
@@ -186,7 +186,7 @@ namespace vrock::security
         CryptoPP::CBC_Mode<CryptoPP::AES>::Encryption e;
         e.SetKeyWithIV( key.data( ), key.size( ), iv.data( ) );
         return_t cipher;
-        CryptoPP::StringSource s( to_string( data ), true,
+        CryptoPP::StringSource s( data.data( ), data.size( ), true,
                                   new CryptoPP::StreamTransformationFilter( e, new CryptoPP::VectorSink( cipher ),
                                                                             convert_padding_scheme( padding ) ) );
         return cipher;
@@ -201,7 +201,7 @@ namespace vrock::security
         d.SetKeyWithIV( key.data( ), key.size( ), iv.data( ) );
 
         return_t decrypted;
-        CryptoPP::StringSource s( to_string( data ), true,
+        CryptoPP::StringSource s( data.data( ), data.size( ), true,
                                   new CryptoPP::StreamTransformationFilter( d, new CryptoPP::VectorSink( decrypted ),
                                                                             convert_padding_scheme( padding ) ) );
 
@@ -237,6 +237,18 @@ namespace vrock::security
         return decrypted;
     }
 
+    auto decrypt_aes_cbc_in_place( byte_span_t data, byte_span_t key, byte_span_t iv ) -> void
+    {
+        if ( iv.size( ) != 16 )
+            throw std::invalid_argument( "initialization vector has to have a length of 16 bytes" );
+        if ( data.size( ) % CryptoPP::AES::BLOCKSIZE != 0 )
+            throw std::invalid_argument( "data has to be a multiple of the block size" );
+
+        CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption d;
+        d.SetKeyWithIV( key.data( ), key.size( ), iv.data( ) );
+        d.ProcessData( data.data( ), data.data( ), data.size( ) );
+    }
+
     auto encrypt_rc4( byte_span_t data, byte_span_t key ) -> return_t
     {
         CryptoPP::Weak::ARC4 rc4;
@@ -277,4 +289,112 @@ namespace vrock::security
     {
         return encrypt_rc4( data, key );
     }
+
+    auto decrypt_rc4_in_place( byte_span_t data, byte_span_t key ) -> void
+    {
+        CryptoPP::Weak::ARC4 rc4;
+
+        if ( rc4.MaxKeyLength( ) < key.size( ) || rc4.MinKeyLength( ) > key.size( ) )
+            throw std::invalid_argument( "the key is of invalid length" );
+
+        rc4.SetKey( key.data( ), key.size( ) );
+        rc4.ProcessData( data.data( ), data.data( ), data.size( ) );
+    }
+
+    struct CipherStream::State
+    {
+        CipherMode mode;
+        CipherDirection direction;
+        std::unique_ptr<CryptoPP::StreamTransformation> cipher;
+        // the same object as cipher for GCM
+        CryptoPP::AuthenticatedSymmetricCipher *authenticated = nullptr;
+    };
+
+    namespace
+    {
+        template <typename Encryption, typename Decryption>
+        auto make_cipher( CipherDirection direction, byte_span_t key, byte_span_t iv )
+            -> std::unique_ptr<CryptoPP::SymmetricCipher>
+        {
+            std::unique_ptr<CryptoPP::SymmetricCipher> cipher;
+            if ( direction == CipherDirection::Encrypt )
+                cipher = std::make_unique<Encryption>( );
+            else
+                cipher = std::make_unique<Decryption>( );
+            cipher->SetKeyWithIV( key.data( ), key.size( ), iv.data( ), iv.size( ) );
+            return cipher;
+        }
+    } // namespace
+
+    CipherStream::CipherStream( CipherMode mode, CipherDirection direction, byte_span_t key, byte_span_t iv )
+        : state( std::make_unique<State>( mode, direction ) )
+    {
+        if ( mode != CipherMode::RC4 && mode != CipherMode::AES_GCM && iv.size( ) != 16 )
+            throw std::invalid_argument( "initialization vector has to have a length of 16 bytes" );
+
+        switch ( mode )
+        {
+        case CipherMode::AES_CBC:
+            state->cipher = make_cipher<CryptoPP::CBC_Mode<CryptoPP::AES>::Encryption,
+                                        CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption>( direction, key, iv );
+            break;
+        case CipherMode::AES_CTR:
+            state->cipher = make_cipher<CryptoPP::CTR_Mode<CryptoPP::AES>::Encryption,
+                                        CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption>( direction, key, iv );
+            break;
+        case CipherMode::AES_GCM: {
+            std::unique_ptr<CryptoPP::AuthenticatedSymmetricCipher> gcm;
+            if ( direction == CipherDirection::Encrypt )
+                gcm = std::make_unique<CryptoPP::GCM<CryptoPP::AES>::Encryption>( );
+            else
+                gcm = std::make_unique<CryptoPP::GCM<CryptoPP::AES>::Decryption>( );
+            gcm->SetKeyWithIV( key.data( ), key.size( ), iv.data( ), iv.size( ) );
+            state->authenticated = gcm.get( );
+            state->cipher = std::move( gcm );
+            break;
+        }
+        case CipherMode::RC4: {
+            auto rc4 = std::make_unique<CryptoPP::Weak::ARC4>( );
+            if ( rc4->MaxKeyLength( ) < key.size( ) || rc4->MinKeyLength( ) > key.size( ) )
+                throw std::invalid_argument( "the key is of invalid length" );
+            rc4->SetKey( key.data( ), key.size( ) );
+            state->cipher = std::move( rc4 );
+            break;
+        }
+        default:
+            throw std::invalid_argument( "unknown cipher mode" );
+        }
+    }
+
+    CipherStream::~CipherStream( ) = default;
+    CipherStream::CipherStream( CipherStream && ) noexcept = default;
+    auto CipherStream::operator=( CipherStream && ) noexcept -> CipherStream & = default;
+
+    auto CipherStream::add_authentication_data( byte_span_t data ) -> void
+    {
+        if ( state->authenticated == nullptr )
+            throw std::logic_error( "authentication data is only used by GCM" );
+        state->authenticated->Update( data.data( ), data.size( ) );
+    }
+
+    auto CipherStream::process( byte_span_t in, byte_span_t out ) -> void
+    {
+        if ( out.size( ) < in.size( ) )
+            throw std::invalid_argument( "the output buffer is smaller than the input" );
+        if ( state->mode == CipherMode::AES_CBC && in.size( ) % CryptoPP::AES::BLOCKSIZE != 0 )
+            throw std::invalid_argument( "data has to be a multiple of the block size" );
+        state->cipher->ProcessData( out.data( ), in.data( ), in.size( ) );
+    }
+
+    auto CipherStream::finalize( byte_span_t tag ) -> void
+    {
+        if ( state->authenticated == nullptr )
+            return;
+        if ( tag.size( ) != 16 )
+            throw std::invalid_argument( "the authentication tag has to have a length of 16 bytes" );
+        if ( state->direction == CipherDirection::Encrypt )
+            state->authenticated->TruncatedFinal( tag.data( ), tag.size( ) );
+        else if ( !state->authenticated->TruncatedVerify( tag.data( ), tag.size( ) ) )
+            throw std::runtime_error( "the authentication tag does not match" );
+    }
 } // namespace vrock::security
\ No newline at end of file
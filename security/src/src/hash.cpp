@@ -4,8 +4,128 @@
 #define CRYPTOPP_ENABLE_NAMESPACE_WEAK 1
 #include "cryptopp/md5.h"
 
+#include <stdexcept>
+
 namespace vrock::security
 {
+    namespace
+    {
+        template <typename Hash>
+        auto hash_batch( std::span<const byte_span_t> data, byte_span_t out ) -> void
+        {
+            Hash hash;
+            auto size = static_cast<std::size_t>( hash.DigestSize( ) );
+            if ( out.size( ) < data.size( ) * size )
+                throw std::invalid_argument( "the output buffer is too small for the digests" );
+            // Final restarts the hash, so the same state is used for every element
+            auto digest = out.data( );
+            for ( const auto &d : data )
+            {
+                hash.Update( d.data( ), d.size( ) );
+                hash.Final( digest );
+                digest += size;
+            }
+        }
+    } // namespace
+
+    auto digest_size( HashAlgorithm algorithm ) -> std::size_t
+    {
+        switch ( algorithm )
+        {
+        case HashAlgorithm::MD5:
+            return CryptoPP::Weak::MD5::DIGESTSIZE;
+        case HashAlgorithm::SHA224:
+            return CryptoPP::SHA224::DIGESTSIZE;
+        case HashAlgorithm::SHA256:
+            return CryptoPP::SHA256::DIGESTSIZE;
+        case HashAlgorithm::SHA384:
+            return CryptoPP::SHA384::DIGESTSIZE;
+        case HashAlgorithm::SHA512:
+            return CryptoPP::SHA512::DIGESTSIZE;
+        }
+        throw std::invalid_argument( "unknown hash algorithm" );
+    }
+
+    auto hash_batch( HashAlgorithm algorithm, std::span<const byte_span_t> data, byte_span_t out ) -> void
+    {
+        switch ( algorithm )
+        {
+        case HashAlgorithm::MD5:
+            return hash_batch<CryptoPP::Weak::MD5>( data, out );
+        case HashAlgorithm::SHA224:
+            return hash_batch<CryptoPP::SHA224>( data, out );
+        case HashAlgorithm::SHA256:
+            return hash_batch<CryptoPP::SHA256>( data, out );
+        case HashAlgorithm::SHA384:
+            return hash_batch<CryptoPP::SHA384>( data, out );
+        case HashAlgorithm::SHA512:
+            return hash_batch<CryptoPP::SHA512>( data, out );
+        }
+        throw std::invalid_argument( "unknown hash algorithm" );
+    }
+
+    struct Hasher::State
+    {
+        std::unique_ptr<CryptoPP::HashTransformation> hash;
+    };
+
+    Hasher::Hasher( HashAlgorithm algorithm ) : state( std::make_unique<State>( ) )
+    {
+        switch ( algorithm )
+        {
+        case HashAlgorithm::MD5:
+            state->hash = std::make_unique<CryptoPP::Weak::MD5>( );
+            break;
+        case HashAlgorithm::SHA224:
+            state->hash = std::make_unique<CryptoPP::SHA224>( );
+            break;
+        case HashAlgorithm::SHA256:
+            state->hash = std::make_unique<CryptoPP::SHA256>( );
+            break;
+        case HashAlgorithm::SHA384:
+            state->hash = std::make_unique<CryptoPP::SHA384>( );
+            break;
+        case HashAlgorithm::SHA512:
+            state->hash = std::make_unique<CryptoPP::SHA512>( );
+            break;
+        default:
+            throw std::invalid_argument( "unknown hash algorithm" );
+        }
+    }
+
+    Hasher::~Hasher( ) = default;
+    Hasher::Hasher( Hasher && ) noexcept = default;
+    auto Hasher::operator=( Hasher && ) noexcept -> Hasher & = default;
+
+    auto Hasher::update( byte_span_t data ) -> void
+    {
+        state->hash->Update( data.data( ), data.size( ) );
+    }
+
+    auto Hasher::update( string_view_t data ) -> void
+    {
+        state->hash->Update( reinterpret_cast<const CryptoPP::byte *>( data.data( ) ), data.size( ) );
+    }
+
+    auto Hasher::finalize( byte_span_t out ) -> void
+    {
+        if ( out.size( ) < digest_size( ) )
+            throw std::invalid_argument( "the output buffer is too small for the digest" );
+        state->hash->Final( out.data( ) );
+    }
+
+    auto Hasher::finalize( ) -> return_t
+    {
+        return_t hashed( digest_size( ) );
+        state->hash->Final( hashed.data( ) );
+        return hashed;
+    }
+
+    auto Hasher::digest_size( ) const -> std::size_t
+    {
+        return state->hash->DigestSize( );
+    }
+
     auto md5( byte_span_t data ) -> return_t
     {
         CryptoPP::Weak::MD5 hash;
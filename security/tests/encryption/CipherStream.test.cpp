@@ -0,0 +1,101 @@
+#include <vrock/security.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace vrock::security;
+
+namespace
+{
+    // processes data in chunks of chunk bytes
+    auto process( CipherStream &stream, std::vector<uint8_t> data, std::size_t chunk ) -> std::vector<uint8_t>
+    {
+        byte_span_t span = data;
+        for ( std::size_t offset = 0; offset < data.size( ); offset += chunk )
+        {
+            auto part = span.subspan( offset, std::min( chunk, data.size( ) - offset ) );
+            stream.process( part, part );
+        }
+        return data;
+    }
+} // namespace
+
+TEST( CipherStreamTest, AESCBC )
+{
+    std::vector<uint8_t> key( 32, 0x2A );
+    std::vector<uint8_t> iv( 16, 0x11 );
+    std::vector<uint8_t> data( 1024 );
+    for ( std::size_t i = 0; i < data.size( ); ++i )
+        data[ i ] = static_cast<uint8_t>( i );
+
+    CipherStream encryption( CipherMode::AES_CBC, CipherDirection::Encrypt, key, iv );
+    auto encrypted = process( encryption, data, 64 );
+    EXPECT_EQ( encrypted, encrypt_aes_cbc( data, key, iv ) );
+
+    CipherStream decryption( CipherMode::AES_CBC, CipherDirection::Decrypt, key, iv );
+    EXPECT_EQ( process( decryption, encrypted, 16 ), data );
+
+    std::vector<uint8_t> partial( 15 );
+    EXPECT_THROW( decryption.process( partial, partial ), std::invalid_argument );
+    EXPECT_THROW( CipherStream( CipherMode::AES_CBC, CipherDirection::Encrypt, key, { } ), std::invalid_argument );
+}
+
+TEST( CipherStreamTest, AESCTR )
+{
+    std::vector<uint8_t> key( 16, 0x01 );
+    std::vector<uint8_t> iv( 16, 0x02 );
+    std::vector<uint8_t> data( 1000, 'x' );
+
+    CipherStream encryption( CipherMode::AES_CTR, CipherDirection::Encrypt, key, iv );
+    auto encrypted = process( encryption, data, 7 );
+    EXPECT_NE( encrypted, data );
+
+    CipherStream decryption( CipherMode::AES_CTR, CipherDirection::Decrypt, key, iv );
+    EXPECT_EQ( process( decryption, encrypted, 100 ), data );
+}
+
+TEST( CipherStreamTest, AESGCM )
+{
+    std::vector<uint8_t> key( 32, 0x03 );
+    std::vector<uint8_t> iv( 12, 0x04 );
+    std::vector<uint8_t> aad = { 'h', 'e', 'a', 'd', 'e', 'r' };
+    std::vector<uint8_t> data( 500, 'y' );
+
+    CipherStream encryption( CipherMode::AES_GCM, CipherDirection::Encrypt, key, iv );
+    encryption.add_authentication_data( aad );
+    auto encrypted = process( encryption, data, 33 );
+    std::vector<uint8_t> tag( 16 );
+    encryption.finalize( tag );
+
+    auto expected = encrypted;
+    expected.insert( expected.end( ), tag.begin( ), tag.end( ) );
+    EXPECT_EQ( expected, encrypt_aes_gcm( data, key, iv, aad ) );
+
+    CipherStream decryption( CipherMode::AES_GCM, CipherDirection::Decrypt, key, iv );
+    decryption.add_authentication_data( aad );
+    EXPECT_EQ( process( decryption, encrypted, 64 ), data );
+    EXPECT_NO_THROW( decryption.finalize( tag ) );
+
+    tag[ 0 ] ^= 1;
+    CipherStream tampered( CipherMode::AES_GCM, CipherDirection::Decrypt, key, iv );
+    tampered.add_authentication_data( aad );
+    process( tampered, encrypted, 64 );
+    EXPECT_THROW( tampered.finalize( tag ), std::runtime_error );
+}
+
+TEST( CipherStreamTest, RC4 )
+{
+    std::vector<uint8_t> key = { 'K', 'e', 'y' };
+    std::vector<uint8_t> data( 300, 'z' );
+
+    CipherStream encryption( CipherMode::RC4, CipherDirection::Encrypt, key );
+    auto encrypted = process( encryption, data, 13 );
+    EXPECT_EQ( encrypted, encrypt_rc4( data, key ) );
+
+    CipherStream decryption( CipherMode::RC4, CipherDirection::Decrypt, key );
+    EXPECT_EQ( process( decryption, encrypted, 50 ), data );
+    EXPECT_THROW( decryption.add_authentication_data( key ), std::logic_error );
+
+    EXPECT_THROW( CipherStream( CipherMode::RC4, CipherDirection::Decrypt, { } ), std::invalid_argument );
+    std::vector<uint8_t> long_key( 257, 'k' );
+    EXPECT_THROW( CipherStream( CipherMode::RC4, CipherDirection::Decrypt, long_key ), std::invalid_argument );
+}
\ No newline at end of file
@@ -62,4 +62,20 @@ TEST( AESTest, AESCBCTest )
         EXPECT_EQ( to_hex_string( encrypted ), "dc95c078a2408989ad48a21492842087" );
         EXPECT_EQ( decrypt_aes_cbc( encrypted, to_string( key ), to_string( iv ) ), to_string( data ) );
     }
+}
+
+TEST( AESTest, AESCBCInPlaceTest )
+{
+    std::vector<std::uint8_t> data( 48 );
+    for ( std::size_t i = 0; i < data.size( ); ++i )
+        data[ i ] = static_cast<std::uint8_t>( i );
+    std::vector<std::uint8_t> key( 16, '\x01' );
+    std::vector<std::uint8_t> iv( 16, '\x02' );
+
+    auto encrypted = encrypt_aes_cbc( data, key, iv );
+    decrypt_aes_cbc_in_place( encrypted, key, iv );
+    EXPECT_EQ( encrypted, data );
+
+    std::vector<std::uint8_t> partial( 17, '\0' );
+    EXPECT_THROW( decrypt_aes_cbc_in_place( partial, key, iv ), std::invalid_argument );
 }
\ No newline at end of file
@@ -22,4 +22,20 @@ TEST( RC4Test, RC4Test )
         EXPECT_EQ( to_hex_string( enc ), "de188941a3375d3a8a06" );
         EXPECT_EQ( decrypt_rc4( enc, to_string( key ) ), to_string( data ) );
     }
+}
+
+TEST( RC4Test, RC4InPlaceTest )
+{
+    std::vector<std::uint8_t> data( 10, '\0' );
+    std::vector<std::uint8_t> key( 10, '\0' );
+
+    decrypt_rc4_in_place( data, key );
+    EXPECT_EQ( to_hex_string( data ), "de188941a3375d3a8a06" );
+    decrypt_rc4_in_place( data, key );
+    EXPECT_EQ( data, std::vector<std::uint8_t>( 10, '\0' ) );
+
+    std::vector<std::uint8_t> short_key;
+    std::vector<std::uint8_t> long_key( 257, '\0' );
+    EXPECT_THROW( decrypt_rc4_in_place( data, short_key ), std::invalid_argument );
+    EXPECT_THROW( decrypt_rc4_in_place( data, long_key ), std::invalid_argument );
 }
\ No newline at end of file
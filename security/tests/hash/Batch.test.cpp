@@ -0,0 +1,59 @@
+#include <vrock/security.hpp>
+
+#include <gtest/gtest.h>
+
+#include <vrock/utils/SpanHelpers.hpp>
+
+using namespace vrock::utils;
+using namespace vrock::security;
+
+TEST( HashBatchTest, MatchesSingleHashes )
+{
+    std::vector<std::vector<uint8_t>> buffers = { { }, { 'T', 'e', 's', 't' }, std::vector<uint8_t>( 1000, 'x' ) };
+    std::vector<byte_span_t> data( buffers.begin( ), buffers.end( ) );
+
+    for ( auto algorithm : { HashAlgorithm::MD5, HashAlgorithm::SHA224, HashAlgorithm::SHA256, HashAlgorithm::SHA384,
+                             HashAlgorithm::SHA512 } )
+    {
+        auto size = digest_size( algorithm );
+        std::vector<uint8_t> out( data.size( ) * size );
+        hash_batch( algorithm, data, out );
+        for ( std::size_t i = 0; i < data.size( ); ++i )
+        {
+            return_t expected;
+            switch ( algorithm )
+            {
+            case HashAlgorithm::MD5:
+                expected = md5( data[ i ] );
+                break;
+            case HashAlgorithm::SHA224:
+                expected = sha224( data[ i ] );
+                break;
+            case HashAlgorithm::SHA256:
+                expected = sha256( data[ i ] );
+                break;
+            case HashAlgorithm::SHA384:
+                expected = sha384( data[ i ] );
+                break;
+            case HashAlgorithm::SHA512:
+                expected = sha512( data[ i ] );
+                break;
+            }
+            ASSERT_EQ( expected.size( ), size );
+            EXPECT_EQ( return_t( out.begin( ) + i * size, out.begin( ) + ( i + 1 ) * size ), expected );
+        }
+    }
+}
+
+TEST( HashBatchTest, SHA256Test )
+{
+    std::vector<uint8_t> data = { 'T', 'e', 's', 't' };
+    std::vector<byte_span_t> batch = { data, data };
+    std::vector<uint8_t> out( 2 * digest_size( HashAlgorithm::SHA256 ) );
+    hash_batch( HashAlgorithm::SHA256, batch, out );
+    EXPECT_EQ( to_hex_string( std::span( out.data( ) + 32, 32 ) ),
+               "532eaabd9574880dbf76b9b8cc00832c20a6ec113d682299550d7a6e0f345e25" );
+
+    std::vector<uint8_t> small( 32 );
+    EXPECT_THROW( hash_batch( HashAlgorithm::SHA256, batch, small ), std::invalid_argument );
+}
\ No newline at end of file
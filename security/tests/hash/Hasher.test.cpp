@@ -0,0 +1,47 @@
+#include <vrock/security.hpp>
+
+#include <gtest/gtest.h>
+
+#include <vrock/utils/SpanHelpers.hpp>
+
+using namespace vrock::utils;
+using namespace vrock::security;
+
+TEST( HasherTest, MatchesSingleHashes )
+{
+    std::vector<uint8_t> data( 10000 );
+    for ( std::size_t i = 0; i < data.size( ); ++i )
+        data[ i ] = static_cast<uint8_t>( i * 7 );
+    byte_span_t span = data;
+
+    for ( auto algorithm : { HashAlgorithm::MD5, HashAlgorithm::SHA224, HashAlgorithm::SHA256, HashAlgorithm::SHA384,
+                             HashAlgorithm::SHA512 } )
+    {
+        std::vector<uint8_t> expected( digest_size( algorithm ) );
+        hash_batch( algorithm, std::span( &span, 1 ), expected );
+
+        Hasher hasher( algorithm );
+        EXPECT_EQ( hasher.digest_size( ), expected.size( ) );
+        for ( std::size_t offset = 0; offset < data.size( ); offset += 999 )
+            hasher.update( span.subspan( offset, std::min<std::size_t>( 999, data.size( ) - offset ) ) );
+        EXPECT_EQ( hasher.finalize( ), expected );
+
+        // the hasher starts over after finalize
+        std::vector<uint8_t> out( hasher.digest_size( ) );
+        hasher.update( span );
+        hasher.finalize( out );
+        EXPECT_EQ( out, expected );
+    }
+}
+
+TEST( HasherTest, SHA256Test )
+{
+    Hasher hasher( HashAlgorithm::SHA256 );
+    hasher.update( "Te" );
+    hasher.update( "st" );
+    auto hash = hasher.finalize( );
+    EXPECT_EQ( to_hex_string( hash ), "532eaabd9574880dbf76b9b8cc00832c20a6ec113d682299550d7a6e0f345e25" );
+
+    std::vector<uint8_t> small( 16 );
+    EXPECT_THROW( hasher.finalize( small ), std::invalid_argument );
+}
\ No newline at end of file
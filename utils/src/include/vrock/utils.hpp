@@ -4,6 +4,7 @@
 #include "utils/FutureHelper.hpp"
 #include "utils/List.hpp"
 #include "utils/SpanHelpers.hpp"
+#include "utils/ThreadPool.hpp"
 #include "utils/Timer.hpp"
 
 #include "utils/CoroutineHelpers.hpp"
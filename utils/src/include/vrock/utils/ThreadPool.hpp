@@ -0,0 +1,112 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vrock::utils
+{
+    /**
+     * @class ThreadPool
+     *
+     * `ThreadPool` runs submitted tasks on a fixed number of worker threads. pending tasks are executed before the
+     * pool is destroyed.
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * @brief starts the worker threads
+         * @param threads number of worker threads, defaults to the number of hardware threads
+         */
+        explicit ThreadPool( std::size_t threads = std::thread::hardware_concurrency( ) )
+        {
+            if ( threads == 0 )
+                threads = 1;
+            workers.reserve( threads );
+            for ( std::size_t i = 0; i < threads; ++i )
+                workers.emplace_back( [ this ]( ) { work( ); } );
+        }
+
+        ThreadPool( const ThreadPool & ) = delete;
+        auto operator=( const ThreadPool & ) -> ThreadPool & = delete;
+
+        /**
+         * @brief finishes all pending tasks and joins the worker threads
+         */
+        ~ThreadPool( )
+        {
+            {
+                std::unique_lock lock( mutex );
+                stopping = true;
+            }
+            condition.notify_all( );
+            for ( auto &worker : workers )
+                worker.join( );
+        }
+
+        /**
+         * @brief queues a function for execution on a worker thread
+         * @param fn function to execute
+         * @param args arguments passed to the function
+         * @return future holding the result or the exception thrown by the function
+         */
+        template <class F, class... Args>
+        auto submit( F &&fn, Args &&...args ) -> std::future<std::invoke_result_t<F, Args...>>
+        {
+            using R = std::invoke_result_t<F, Args...>;
+            auto task = std::make_shared<std::packaged_task<R( )>>(
+                std::bind( std::forward<F>( fn ), std::forward<Args>( args )... ) );
+            auto future = task->get_future( );
+            {
+                std::unique_lock lock( mutex );
+                if ( stopping )
+                    throw std::runtime_error( "submit on stopped ThreadPool" );
+                tasks.emplace( [ task ]( ) { ( *task )( ); } );
+            }
+            condition.notify_one( );
+            return future;
+        }
+
+        /**
+         * @brief gets the number of worker threads
+         * @return number of worker threads
+         */
+        [[nodiscard]] auto size( ) const -> std::size_t
+        {
+            return workers.size( );
+        }
+
+    private:
+        auto work( ) -> void
+        {
+            while ( true )
+            {
+                std::function<void( )> task;
+                {
+                    std::unique_lock lock( mutex );
+                    condition.wait( lock, [ this ]( ) { return stopping || !tasks.empty( ); } );
+                    if ( stopping && tasks.empty( ) )
+                        return;
+                    task = std::move( tasks.front( ) );
+                    tasks.pop( );
+                }
+                task( );
+            }
+        }
+
+        std::vector<std::thread> workers;
+        std::queue<std::function<void( )>> tasks;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopping = false;
+    };
+} // namespace vrock::utils
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include <vrock/utils.hpp>
+
+#include <atomic>
+
+using namespace vrock::utils;
+
+TEST( ThreadPoolTest, ReturnsResults )
+{
+    ThreadPool pool( 4 );
+    std::vector<std::future<int>> futures;
+    for ( int i = 0; i < 100; ++i )
+        futures.emplace_back( pool.submit( []( int x ) { return x * x; }, i ) );
+    for ( int i = 0; i < 100; ++i )
+        EXPECT_EQ( futures[ i ].get( ), i * i );
+}
+
+TEST( ThreadPoolTest, PropagatesExceptions )
+{
+    ThreadPool pool( 2 );
+    auto future = pool.submit( []( ) -> int { throw std::runtime_error( "error" ); } );
+    EXPECT_THROW( future.get( ), std::runtime_error );
+}
+
+TEST( ThreadPoolTest, FinishesPendingTasks )
+{
+    std::atomic<int> counter = 0;
+    {
+        ThreadPool pool( 2 );
+        for ( int i = 0; i < 50; ++i )
+            pool.submit( [ &counter ]( ) { ++counter; } );
+    }
+    EXPECT_EQ( counter, 50 );
+}
+
+TEST( ThreadPoolTest, AtLeastOneThread )
+{
+    ThreadPool pool( 0 );
+    EXPECT_EQ( pool.size( ), 1 );
+    EXPECT_EQ( pool.submit( []( ) { return 1; } ).get( ), 1 );
+}